@@ -0,0 +1,33 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "benchmark_device.hpp"
+
+void BenchmarkDevice::setup(const int width, const int height) {
+    //there is never anything to present to
+    window.makeHeadless(width, height);
+    instance.create(true);
+    surface.setup();
+
+    //the same device the renderer would pick
+    physical_device.setup();
+    queue_family.setup();
+    logical_device.setup();
+
+    command_pool.setup();
+}
+
+void BenchmarkDevice::cleanup() {
+    command_pool.cleanup();
+    logical_device.cleanup();
+    surface.cleanup();
+    instance.cleanup();
+    window.cleanup();
+}
+
+std::string BenchmarkDevice::device_name() {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device.get_device(), &properties);
+    return properties.deviceName;
+}
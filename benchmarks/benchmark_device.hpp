@@ -0,0 +1,41 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_BENCHMARK_DEVICE_HPP
+#define VULKAN_ENGINE_BENCHMARK_DEVICE_HPP
+
+#include <string>
+#include "../window.hpp"
+#include "../instance.hpp"
+#include "../surface.hpp"
+#include "../physical_device.hpp"
+#include "../queue_family.hpp"
+#include "../logical_device.hpp"
+#include "../command_pool.hpp"
+
+//the part of the renderer every benchmark needs -- a device to run on, without a window
+// - the same objects as Renderer, set up in the same order
+// - nothing here needs a display or a GPU, so the benchmarks also run on software implementations (e.g. lavapipe)
+struct BenchmarkDevice {
+    BenchmarkDevice() : surface(window, instance), physical_device(instance, surface), queue_family(physical_device.physicalDevice, surface.surface),
+                        logical_device(physical_device, queue_family), command_pool(logical_device, queue_family) {}
+
+    //width and height are the size of the images rendered to
+    void setup(int width, int height);
+    void cleanup();
+
+    //the name of the graphics card (for the reports)
+    [[nodiscard]] std::string device_name();
+
+    Window window;
+    Instance instance;
+    Surface surface;
+    PhysicalDevice physical_device;
+    QueueFamily queue_family;
+    LogicalDevice logical_device;
+    CommandPool command_pool;
+};
+
+
+#endif //VULKAN_ENGINE_BENCHMARK_DEVICE_HPP
@@ -0,0 +1,100 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "benchmark_report.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+static void write_string(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+void BenchmarkReport::add_result(std::string name) {
+    results.push_back({std::move(name), {}});
+}
+
+void BenchmarkReport::add_metric(std::string name, const double value) {
+    if (results.empty()) {
+        throw std::logic_error("a result must be added before its metrics");
+    }
+    results.back().metrics.emplace_back(std::move(name), value);
+}
+
+void BenchmarkReport::write(const std::string& file) const {
+    std::ofstream out(file);
+    if (!out) {
+        throw std::runtime_error("failed to open benchmark report " + file);
+    }
+
+    out << std::setprecision(9);
+    out << "{\n  \"benchmark\": ";
+    write_string(out, benchmark);
+    out << ",\n  \"device\": ";
+    write_string(out, device);
+    out << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        write_string(out, results[i].name);
+        out << ", \"metrics\": {";
+        for (size_t j = 0; j < results[i].metrics.size(); j++) {
+            const auto& [name, value] = results[i].metrics[j];
+            out << (j == 0 ? "" : ", ");
+            write_string(out, name);
+            //json has no infinity or nan
+            if (std::isfinite(value)) {
+                out << ": " << value;
+            } else {
+                out << ": null";
+            }
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+
+    if (!out) {
+        throw std::runtime_error("failed to write benchmark report " + file);
+    }
+}
+
+double median(std::vector<double> samples) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const auto middle = samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2);
+    std::nth_element(samples.begin(), middle, samples.end());
+    if (samples.size() % 2 == 1) {
+        return *middle;
+    }
+    //the average of the two middle values
+    const auto below = *std::max_element(samples.begin(), middle);
+    return (below + *middle) / 2.0;
+}
+
+size_t peak_host_memory() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);            //bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;     //kilobytes on linux
+#endif
+#else
+    return 0;   //not measured
+#endif
+}
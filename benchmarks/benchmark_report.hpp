@@ -0,0 +1,45 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_BENCHMARK_REPORT_HPP
+#define VULKAN_ENGINE_BENCHMARK_REPORT_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+//the results of a benchmark, written as json so runs can be compared across commits (see perf_gate)
+// - {"benchmark": name, "device": device, "results": [{"name": configuration, "metrics": {metric: value, ...}}, ...]}
+// - every result is one configuration (e.g. a number of objects), and every metric one number measured for it
+struct BenchmarkReport {
+    explicit BenchmarkReport(std::string benchmark_name) : benchmark(std::move(benchmark_name)) {}
+
+    std::string device;     //what the benchmark ran on
+
+    //starting the results of a new configuration
+    void add_result(std::string name);
+    //adding a measurement to the last result
+    void add_metric(std::string name, double value);
+
+    //writing the report to a file
+    void write(const std::string& file) const;
+
+private:
+    struct Result {
+        std::string name;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+    std::string benchmark;
+    std::vector<Result> results;
+};
+
+//the middle value of some samples (0 if there are none)
+[[nodiscard]] double median(std::vector<double> samples);
+
+//the most memory this process has used so far (its peak resident set, in bytes)
+[[nodiscard]] size_t peak_host_memory();
+
+
+#endif //VULKAN_ENGINE_BENCHMARK_REPORT_HPP
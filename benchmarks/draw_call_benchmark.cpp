@@ -0,0 +1,570 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+//benchmark for how the cost of a frame scales with the number of draw calls
+// - draws N small objects (one draw call each) spread over a number of meshes, pipelines and textures, headless
+// - reports the CPU time to record the frame, the time vkQueueSubmit takes and the GPU time of the frame (median of all frames)
+// - objects are drawn sorted by pipeline, then texture, then mesh and state is only bound when it changes (like the renderer)
+// - usage: draw_call_benchmark [--objects n,n,...] [--meshes m] [--pipelines p] [--textures t] [--frames f] [--json file]
+
+#include "benchmark_device.hpp"
+#include "benchmark_report.hpp"
+
+#include "../swap_chain.hpp"
+#include "../image_views.hpp"
+#include "../render_pass.hpp"
+#include "../depth_image.hpp"
+#include "../framebuffers.hpp"
+#include "../pipeline_cache.hpp"
+#include "../graphics_pipeline.hpp"
+#include "../graphics_pipeline/viewport.hpp"
+#include "../graphics_pipeline/scissor.hpp"
+#include "../descriptor_set_layout.hpp"
+#include "../descriptor_pool.hpp"
+#include "../descriptor_set.hpp"
+#include "../uniform_buffer_objects.hpp"
+#include "../texture.hpp"
+#include "../texture_view.hpp"
+#include "../texture_sampler.hpp"
+#include "../vertex_buffer.hpp"
+#include "../index_buffer.hpp"
+#include "../fences.hpp"
+#include "../vertex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numbers>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifndef SHADER_BYTECODE_DIR
+#define SHADER_BYTECODE_DIR "../shader_bytecode/"
+#endif
+
+namespace {
+    constexpr std::string_view vertex_shader_location = SHADER_BYTECODE_DIR "benchmark_vert.spv";
+    constexpr std::string_view fragment_shader_location = SHADER_BYTECODE_DIR "benchmark_frag.spv";
+
+    constexpr int image_width = 800;
+    constexpr int image_height = 600;
+    constexpr unsigned frames_in_flight = 2;
+    constexpr unsigned warmup_frames = 2;       //not measured (the first frames also pay for lazily created driver state)
+    constexpr unsigned max_textures = 64;       //the descriptor pool is made for this many
+    constexpr unsigned texture_size = 64;
+    constexpr uint32_t push_constant_size = sizeof(float) * 4;
+
+    struct Options {
+        std::vector<size_t> object_counts = {1, 10, 100, 1000, 10000, 100000, 1000000};
+        unsigned meshes = 4;
+        unsigned pipelines = 4;
+        unsigned textures = 4;
+        unsigned frames = 20;
+        std::string json_file;  //not written if empty
+    };
+
+    //reading a positive number, or throwing if it isn't one
+    unsigned long parse_count(const std::string& value) {
+        char* end = nullptr;
+        const auto count = std::strtoul(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || count == 0) {
+            throw std::runtime_error("expected a positive number, got '" + value + "'");
+        }
+        return count;
+    }
+
+    Options parse_options(const int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                throw std::runtime_error("missing value for " + arg);
+            }
+            const std::string value = argv[++i];
+
+            if (arg == "--objects") {
+                options.object_counts.clear();
+                size_t start = 0;
+                while (start <= value.size()) {
+                    const auto comma = std::min(value.find(',', start), value.size());
+                    options.object_counts.push_back(parse_count(value.substr(start, comma - start)));
+                    start = comma + 1;
+                }
+            } else if (arg == "--meshes") {
+                options.meshes = static_cast<unsigned>(parse_count(value));
+            } else if (arg == "--pipelines") {
+                options.pipelines = static_cast<unsigned>(parse_count(value));
+            } else if (arg == "--textures") {
+                options.textures = static_cast<unsigned>(parse_count(value));
+            } else if (arg == "--frames") {
+                options.frames = static_cast<unsigned>(parse_count(value));
+            } else if (arg == "--json") {
+                options.json_file = value;
+            } else {
+                throw std::runtime_error("unknown option " + arg);
+            }
+        }
+        if (options.textures > max_textures) {
+            throw std::runtime_error("at most " + std::to_string(max_textures) + " textures are supported");
+        }
+        return options;
+    }
+
+    //a regular polygon centred on the origin with a radius of 1
+    // - each mesh has a different number of sides so they are actually different meshes
+    struct Mesh {
+        Mesh(LogicalDevice& device, CommandPool& command_pool, const unsigned sides) : vertex_buffer(device, command_pool, vertices), index_buffer(device, command_pool, indices) {
+            vertices.push_back({{0.0f, 0.0f}, {0.5f, 0.5f}});
+            for (unsigned i = 0; i < sides; i++) {
+                const float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(sides);
+                const glm::vec2 pos(std::cos(angle), std::sin(angle));
+                vertices.push_back({pos, pos * 0.5f + 0.5f});
+            }
+            //a fan of triangles around the centre (counter-clockwise)
+            for (unsigned i = 0; i < sides; i++) {
+                indices.push_back(0);
+                indices.push_back(static_cast<uint16_t>(1 + i));
+                indices.push_back(static_cast<uint16_t>(1 + (i + 1) % sides));
+            }
+            vertex_buffer.setup();
+            index_buffer.setup();
+        }
+
+        void cleanup() {
+            index_buffer.cleanup();
+            vertex_buffer.cleanup();
+        }
+
+        std::vector<Vertex::TWOD_VT> vertices;
+        std::vector<uint16_t> indices;
+        VertexBuffer<Vertex::TWOD_VT> vertex_buffer;
+        IndexBuffer<uint16_t> index_buffer;
+    };
+
+    //a checkerboard texture and the descriptor sets to use it
+    struct BenchmarkTexture {
+        BenchmarkTexture(LogicalDevice& device, CommandPool& command_pool, SwapChain& swap_chain, UniformBufferObject& ubo, DescriptorPool& pool,
+                         DescriptorSetLayout& layout, TextureSampler& sampler, const unsigned index)
+            : texture(device, command_pool, ""), view(device, texture), descriptor_set(device, swap_chain, ubo, pool, layout, sampler, view) {
+            //a different colour for every texture
+            const auto r = static_cast<unsigned char>(64 + 37 * index);
+            const auto g = static_cast<unsigned char>(255 - 23 * index);
+            const auto b = static_cast<unsigned char>(128 + 71 * index);
+
+            std::vector<unsigned char> pixels(texture_size * texture_size * 4);
+            for (unsigned y = 0; y < texture_size; y++) {
+                for (unsigned x = 0; x < texture_size; x++) {
+                    const bool dark = ((x / 8) + (y / 8)) % 2 == 0;
+                    auto* pixel = &pixels[(y * texture_size + x) * 4];
+                    pixel[0] = dark ? static_cast<unsigned char>(r / 2) : r;
+                    pixel[1] = dark ? static_cast<unsigned char>(g / 2) : g;
+                    pixel[2] = dark ? static_cast<unsigned char>(b / 2) : b;
+                    pixel[3] = 255;
+                }
+            }
+            texture.setup(pixels.data(), texture_size, texture_size);
+            view.setup();
+            descriptor_set.setup();
+        }
+
+        //the descriptor sets are freed with the pool
+        void cleanup() {
+            view.cleanup();
+            texture.cleanup();
+        }
+
+        Texture texture;
+        TextureView view;
+        DescriptorSet2 descriptor_set;
+    };
+
+    //what is drawn for one object
+    struct Object {
+        uint32_t pipeline;
+        uint32_t texture;
+        uint32_t mesh;
+        glm::vec4 offset_scale;     //the push constants
+    };
+
+    //spreading the objects over a grid covering the image and sorting them into the order they are drawn in
+    std::vector<Object> make_objects(const size_t no_objects, const Options& options) {
+        const auto side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(no_objects))));
+        const float cell = 2.0f / static_cast<float>(side);
+
+        std::vector<Object> objects(no_objects);
+        for (size_t i = 0; i < no_objects; i++) {
+            const auto x = static_cast<float>(i % side);
+            const auto y = static_cast<float>(i / side);
+            objects[i].pipeline = static_cast<uint32_t>(i % options.pipelines);
+            objects[i].texture = static_cast<uint32_t>((i / options.pipelines) % options.textures);
+            objects[i].mesh = static_cast<uint32_t>((i / (options.pipelines * options.textures)) % options.meshes);
+            objects[i].offset_scale = glm::vec4(-1.0f + (x + 0.5f) * cell, -1.0f + (y + 0.5f) * cell, 0.45f * cell, 0.0f);
+        }
+        std::sort(objects.begin(), objects.end(), [](const Object& a, const Object& b) {
+            if (a.pipeline != b.pipeline) return a.pipeline < b.pipeline;
+            if (a.texture != b.texture) return a.texture < b.texture;
+            return a.mesh < b.mesh;
+        });
+        return objects;
+    }
+
+    //the command buffer and timestamps of a frame in flight
+    struct FrameSlot {
+        VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        VkQueryPool timestamps = VK_NULL_HANDLE;    //null if the queue can't write timestamps
+        bool measured = false;                      //if the last frame that used this slot is measured and its GPU time not read yet
+    };
+
+    struct Measurements {
+        std::vector<double> record_ms;
+        std::vector<double> submit_ms;
+        std::vector<double> gpu_ms;
+    };
+
+    double ms_since(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //everything needed to draw, made once and used for every configuration
+    struct DrawCallBenchmark {
+        explicit DrawCallBenchmark(BenchmarkDevice& d)
+            : device(d), swap_chain(d.window, d.logical_device, d.surface, d.queue_family), image_views(swap_chain, d.logical_device), render_pass(d.logical_device, swap_chain),
+              depth_image(d.logical_device, swap_chain), framebuffers(d.logical_device, image_views, render_pass, swap_chain, depth_image),
+              pipeline_cache(d.logical_device, ""), shader_cache(d.logical_device), descriptor_set_layout(d.logical_device), ubo(d.logical_device, swap_chain),
+              sampler(d.logical_device), descriptor_pool(d.logical_device, swap_chain), fences(d.logical_device) {}
+
+        void setup(const Options& options);
+        void cleanup();
+
+        //drawing the objects for warmup_frames + options.frames frames
+        Measurements run(const std::vector<Object>& objects, const Options& options);
+
+    private:
+        void record(FrameSlot& slot, unsigned image_index, const std::vector<Object>& objects);
+        //reading the GPU time of the last frame that used the slot (its fence must have been waited on)
+        void read_timestamps(FrameSlot& slot, Measurements& measurements) const;
+
+        BenchmarkDevice& device;
+        SwapChain swap_chain;
+        ImageViews image_views;
+        RenderPass render_pass;
+        DepthImage depth_image;
+        Framebuffers framebuffers;
+        PipelineCache pipeline_cache;   //never saved, so every run compiles the pipelines
+        ShaderCache shader_cache;
+        DescriptorSetLayout2 descriptor_set_layout;
+        UniformBufferObject ubo;        //only there because the layout has one (the objects are placed with push constants)
+        TextureSampler sampler;
+        DescriptorPool2<max_textures> descriptor_pool;
+        Fences fences;
+
+        std::vector<std::unique_ptr<GraphicsPipeline<Vertex::TWOD_VT>>> pipelines;
+        std::vector<std::unique_ptr<Mesh>> meshes;
+        std::vector<std::unique_ptr<BenchmarkTexture>> textures;
+        std::array<FrameSlot, frames_in_flight> slots{};
+
+        double ns_per_tick = 1.0;
+        uint64_t timestamp_mask = UINT64_MAX;
+    };
+
+    void DrawCallBenchmark::setup(const Options& options) {
+        auto& logical_device = device.logical_device;
+
+        swap_chain.present_settings.frames_in_flight = frames_in_flight;
+        swap_chain.setup();
+        image_views.setup();
+        descriptor_set_layout.setup();
+        render_pass.setup();
+        pipeline_cache.setup();
+
+        //every pipeline uses the same shaders with a different tint, so they can't be merged by the driver
+        PipelineState state;
+        state.cull_mode = VK_CULL_MODE_NONE;
+        for (unsigned i = 0; i < options.pipelines; i++) {
+            const float tint = 1.0f - 0.5f * static_cast<float>(i) / static_cast<float>(options.pipelines);
+            pipelines.push_back(std::make_unique<GraphicsPipeline<Vertex::TWOD_VT>>(logical_device, render_pass, pipeline_cache, shader_cache, std::vector<DescriptorSetLayout*>{&descriptor_set_layout},
+                vertex_shader_location, fragment_shader_location, SpecializationConstants(), SpecializationConstants().set(0, tint), state, push_constant_size));
+            pipelines.back()->setup();
+        }
+
+        ubo.setup();
+        sampler.setup(VK_FILTER_NEAREST, VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+        descriptor_pool.setup();
+        for (unsigned i = 0; i < options.textures; i++) {
+            textures.push_back(std::make_unique<BenchmarkTexture>(logical_device, device.command_pool, swap_chain, ubo, descriptor_pool, descriptor_set_layout, sampler, i));
+        }
+        for (unsigned i = 0; i < options.meshes; i++) {
+            meshes.push_back(std::make_unique<Mesh>(logical_device, device.command_pool, 3 + i));
+        }
+
+        depth_image.setup();
+        framebuffers.setup();
+        fences.setup(frames_in_flight);
+
+        //the command buffers
+        std::array<VkCommandBuffer, frames_in_flight> command_buffers{};
+        VkCommandBufferAllocateInfo allocInfo{};    //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkCommandBufferAllocateInfo.html
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = device.command_pool.get_command_pool();
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = frames_in_flight;
+        if (vkAllocateCommandBuffers(logical_device.get_device(), &allocInfo, command_buffers.data()) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate command buffers!");
+        }
+
+        //the timestamps at the start and end of every frame
+        // - timestampValidBits is 0 if the queue can't write them (the GPU time is then not reported)
+        uint32_t queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device.physical_device.get_device(), &queue_family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(device.physical_device.get_device(), &queue_family_count, queue_families.data());
+        const auto valid_bits = queue_families[device.queue_family.graphicsFamily.value()].timestampValidBits;
+        timestamp_mask = valid_bits >= 64 ? UINT64_MAX : (uint64_t{1} << valid_bits) - 1;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device.physical_device.get_device(), &properties);
+        ns_per_tick = static_cast<double>(properties.limits.timestampPeriod);
+
+        for (unsigned i = 0; i < frames_in_flight; i++) {
+            slots[i].command_buffer = command_buffers[i];
+            if (valid_bits == 0) {
+                continue;
+            }
+            VkQueryPoolCreateInfo poolInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkQueryPoolCreateInfo.html
+            poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            poolInfo.queryCount = 2;
+            if (vkCreateQueryPool(logical_device.get_device(), &poolInfo, nullptr, &slots[i].timestamps) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create timestamp query pool");
+            }
+        }
+    }
+
+    void DrawCallBenchmark::cleanup() {
+        const auto d = device.logical_device.get_device();
+        vkDeviceWaitIdle(d);
+
+        for (auto& slot : slots) {
+            if (slot.timestamps != VK_NULL_HANDLE) {
+                vkDestroyQueryPool(d, slot.timestamps, nullptr);
+            }
+            vkFreeCommandBuffers(d, device.command_pool.get_command_pool(), 1, &slot.command_buffer);
+        }
+        fences.cleanup();
+        framebuffers.cleanup();
+        depth_image.cleanup();
+
+        for (auto& mesh : meshes) {
+            mesh->cleanup();
+        }
+        for (auto& texture : textures) {
+            texture->cleanup();
+        }
+        descriptor_pool.cleanup();
+        sampler.cleanup();
+        ubo.cleanup();
+
+        for (auto& pipeline : pipelines) {
+            pipeline->cleanup();
+        }
+        shader_cache.cleanup();
+        pipeline_cache.cleanup();
+        render_pass.cleanup();
+        descriptor_set_layout.cleanup();
+        image_views.cleanup();
+        swap_chain.cleanup();
+    }
+
+    void DrawCallBenchmark::record(FrameSlot& slot, const unsigned image_index, const std::vector<Object>& objects) {
+        const auto command_buffer = slot.command_buffer;
+
+        VkCommandBufferBeginInfo beginInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkCommandBufferBeginInfo.html
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;     //re-recorded every frame
+        if (vkBeginCommandBuffer(command_buffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("failed to begin recording command buffer!");
+        }
+
+        if (slot.timestamps != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(command_buffer, slot.timestamps, 0, 2);
+            vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.timestamps, 0);
+        }
+
+        VkRenderPassBeginInfo renderPassInfo{};     //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkRenderPassBeginInfo.html
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = render_pass.get_render_pass();
+        renderPassInfo.framebuffer = framebuffers.swapChainFramebuffers[image_index];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = swap_chain.extent;
+        std::array<VkClearValue, 2> clearValues{};
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+        renderPassInfo.clearValueCount = clearValues.size();
+        renderPassInfo.pClearValues = clearValues.data();
+        vkCmdBeginRenderPass(command_buffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        Viewport viewport(static_cast<float>(swap_chain.extent.width), static_cast<float>(swap_chain.extent.height));
+        Scissor scissor(swap_chain.extent);
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport.get_pipeline_stage());
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor.get_pipeline_stage());
+
+        //only binding what changed since the last object
+        uint32_t bound_pipeline = UINT32_MAX, bound_texture = UINT32_MAX, bound_mesh = UINT32_MAX;
+        std::optional<PipelineState> bound_state;
+        for (const auto& object : objects) {
+            auto& pipeline = *pipelines[object.pipeline];
+            if (object.pipeline != bound_pipeline) {
+                pipeline.bind(command_buffer, bound_state);
+                bound_pipeline = object.pipeline;
+                bound_texture = UINT32_MAX;     //a new pipeline layout, so the descriptor set is bound again
+            }
+            if (object.texture != bound_texture) {
+                vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline_layout, 0, 1,
+                                        &textures[object.texture]->descriptor_set.get_sets()[image_index], 0, nullptr);
+                bound_texture = object.texture;
+            }
+            auto& mesh = *meshes[object.mesh];
+            if (object.mesh != bound_mesh) {
+                const VkDeviceSize offset = 0;
+                vkCmdBindVertexBuffers(command_buffer, 0, 1, &mesh.vertex_buffer.get_buffer(), &offset);
+                vkCmdBindIndexBuffer(command_buffer, mesh.index_buffer.get_buffer(), 0, VK_INDEX_TYPE_UINT16);
+                bound_mesh = object.mesh;
+            }
+
+            vkCmdPushConstants(command_buffer, pipeline.pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, push_constant_size, &object.offset_scale);
+            vkCmdDrawIndexed(command_buffer, static_cast<uint32_t>(mesh.indices.size()), 1, 0, 0, 0);
+        }
+
+        vkCmdEndRenderPass(command_buffer);
+
+        if (slot.timestamps != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.timestamps, 1);
+        }
+
+        if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to record command buffer!");
+        }
+    }
+
+    void DrawCallBenchmark::read_timestamps(FrameSlot& slot, Measurements& measurements) const {
+        if (!slot.measured || slot.timestamps == VK_NULL_HANDLE) {
+            slot.measured = false;
+            return;
+        }
+        slot.measured = false;
+
+        std::array<uint64_t, 2> ticks{};
+        const auto result = vkGetQueryPoolResults(device.logical_device.get_device(), slot.timestamps, 0, 2, sizeof(ticks), ticks.data(), sizeof(uint64_t),
+                                                  VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) {
+            return;     //not available, the frame just isn't counted
+        }
+        const auto elapsed = ((ticks[1] & timestamp_mask) - (ticks[0] & timestamp_mask)) & timestamp_mask;
+        measurements.gpu_ms.push_back(static_cast<double>(elapsed) * ns_per_tick / 1e6);
+    }
+
+    Measurements DrawCallBenchmark::run(const std::vector<Object>& objects, const Options& options) {
+        const auto d = device.logical_device.get_device();
+        const auto no_images = static_cast<unsigned>(swap_chain.swapChainImages.size());
+        Measurements measurements;
+
+        for (unsigned frame = 0; frame < warmup_frames + options.frames; frame++) {
+            const unsigned current = frame % frames_in_flight;
+            auto& slot = slots[current];
+            auto& fence = fences.get_fences()[current];
+
+            //waiting for the last frame that used this slot, like the renderer does
+            vkWaitForFences(d, 1, &fence, VK_TRUE, UINT64_MAX);
+            read_timestamps(slot, measurements);
+            vkResetFences(d, 1, &fence);
+
+            //there is nothing presenting the images, so just cycle through them
+            // - there are at least as many images as frames in flight, so no two frames in flight use the same one
+            const unsigned image_index = frame % no_images;
+
+            const auto record_start = std::chrono::steady_clock::now();
+            record(slot, image_index, objects);
+            const auto record_ms = ms_since(record_start);
+
+            VkSubmitInfo submitInfo{};      //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkSubmitInfo.html
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &slot.command_buffer;
+            const auto submit_start = std::chrono::steady_clock::now();
+            if (vkQueueSubmit(device.logical_device.graphics_queue, 1, &submitInfo, fence) != VK_SUCCESS) {
+                throw std::runtime_error("failed to submit draw command buffer!");
+            }
+            const auto submit_ms = ms_since(submit_start);
+
+            if (frame >= warmup_frames) {
+                measurements.record_ms.push_back(record_ms);
+                measurements.submit_ms.push_back(submit_ms);
+                slot.measured = true;
+            }
+        }
+
+        //the GPU times of the last frames
+        vkDeviceWaitIdle(d);
+        for (auto& slot : slots) {
+            read_timestamps(slot, measurements);
+        }
+        return measurements;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parse_options(argc, argv);
+
+        BenchmarkDevice device;
+        device.setup(image_width, image_height);
+
+        BenchmarkReport report("draw_calls");
+        report.device = device.device_name();
+        std::cout << "device: " << report.device << ", meshes: " << options.meshes << ", pipelines: " << options.pipelines
+                  << ", textures: " << options.textures << ", frames: " << options.frames << "\n";
+        std::cout << std::setw(10) << "objects" << std::setw(14) << "record (ms)" << std::setw(14) << "submit (ms)" << std::setw(14) << "gpu (ms)"
+                  << std::setw(16) << "draws per ms" << "\n";
+
+        DrawCallBenchmark benchmark(device);
+        benchmark.setup(options);
+
+        for (const auto no_objects : options.object_counts) {
+            const auto objects = make_objects(no_objects, options);
+            const auto measurements = benchmark.run(objects, options);
+
+            const double record_ms = median(measurements.record_ms);
+            const double submit_ms = median(measurements.submit_ms);
+            //NaN (null in the json) if the queue can't write timestamps
+            const double gpu_ms = measurements.gpu_ms.empty() ? std::nan("") : median(measurements.gpu_ms);
+
+            report.add_result(std::to_string(no_objects) + " objects");
+            report.add_metric("objects", static_cast<double>(no_objects));
+            report.add_metric("record_ms", record_ms);
+            report.add_metric("submit_ms", submit_ms);
+            report.add_metric("gpu_ms", gpu_ms);
+
+            std::cout << std::fixed << std::setprecision(3) << std::setw(10) << no_objects << std::setw(14) << record_ms << std::setw(14) << submit_ms
+                      << std::setw(14) << gpu_ms << std::setw(16) << static_cast<double>(no_objects) / record_ms << "\n";
+        }
+
+        benchmark.cleanup();
+        device.cleanup();
+
+        if (!options.json_file.empty()) {
+            report.write(options.json_file);
+            std::cout << "wrote " << options.json_file << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
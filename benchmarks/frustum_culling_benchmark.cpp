@@ -0,0 +1,141 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+//micro-benchmark for the CPU frustum culling
+// - reports how many objects can be culled per millisecond for the scalar kernel, the SIMD kernel, the threaded culler and the BVH
+// - usage: frustum_culling_benchmark [no_objects ...]
+
+#include "../frustum_culling.hpp"
+#include "../job_system.hpp"
+#include "../scene_bvh.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace {
+    //filling a cube around the camera with randomly sized boxes
+    // - roughly 1 in 20 ends up inside the frustum which is typical for an open scene
+    std::vector<AABB> random_boxes(const size_t no_objects) {
+        std::mt19937 rng(1234);     //fixed seed so runs are comparable
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.25f, 2.0f);
+
+        std::vector<AABB> boxes(no_objects);
+        for (auto& box : boxes) {
+            const glm::vec3 center(position(rng), position(rng), position(rng));
+            const glm::vec3 extent(size(rng), size(rng), size(rng));
+            box = {center - extent, center + extent};
+        }
+        return boxes;
+    }
+
+    //runs `cull' repeatedly for at least min_time and returns the number of objects tested per millisecond
+    double objects_per_ms(const size_t no_objects, const std::function<size_t()>& cull) {
+        constexpr auto min_time = std::chrono::milliseconds(250);
+
+        cull(); //warming the caches
+
+        size_t iterations = 0;
+        const auto start = std::chrono::steady_clock::now();
+        auto now = start;
+        while (now - start < min_time) {
+            cull();
+            iterations++;
+            now = std::chrono::steady_clock::now();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(now - start).count();
+        return static_cast<double>(no_objects * iterations) / ms;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> object_counts;
+    for (int i = 1; i < argc; i++) {
+        object_counts.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (object_counts.empty()) {
+        object_counts = {10000, 100000, 1000000};
+    }
+
+    //same camera setup as the renderer, just looking into the cube of objects
+    const auto view = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    auto proj = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    proj[1][1] *= -1;
+    const auto frustum = Frustum::from_matrix(proj * view);
+
+    const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "simd kernel: " << cull_kernel_name() << ", hardware threads: " << hardware_threads << "\n";
+
+    //the workers plus this thread use every hardware thread
+    JobSystem jobs;
+
+    for (const auto no_objects : object_counts) {
+        const auto boxes = random_boxes(no_objects);
+        ObjectBounds bounds;
+        bounds.reserve(no_objects);
+        for (const auto& box : boxes) {
+            bounds.add(box);
+        }
+        std::vector<uint32_t> out(no_objects);
+
+        //the reference result to check the other kernels against
+        const size_t no_visible = cull_range_scalar(frustum, bounds, 0, no_objects, out.data());
+
+        const double scalar = objects_per_ms(no_objects, [&] {
+            return cull_range_scalar(frustum, bounds, 0, no_objects, out.data());
+        });
+        const double simd = objects_per_ms(no_objects, [&] {
+            return cull_range(frustum, bounds, 0, no_objects, out.data());
+        });
+
+        FrustumCuller culler(jobs);
+        std::vector<uint32_t> visible;
+        const double threaded = objects_per_ms(no_objects, [&] {
+            culler.cull(frustum, bounds, visible);
+            return visible.size();
+        });
+
+        //the BVH only looks at the nodes near the frustum so should be much faster for large scenes
+        // - refitting after every object moved a little is the worst case for the incremental update
+        SceneBVH bvh;
+        bvh.build(boxes);
+        std::vector<uint32_t> bvh_visible;
+        const double hierarchical = objects_per_ms(no_objects, [&] {
+            bvh.query(frustum, bvh_visible);
+            return bvh_visible.size();
+        });
+        const double refit = objects_per_ms(no_objects, [&] {
+            for (uint32_t i = 0; i < no_objects; i++) {
+                bvh.update(i, boxes[i]);
+            }
+            bvh.refit();
+            return bvh.size();
+        });
+
+        if (cull_range(frustum, bounds, 0, no_objects, out.data()) != no_visible || visible.size() != no_visible) {
+            std::cerr << "kernels disagree on the number of visible objects\n";
+            return 1;
+        }
+        std::sort(bvh_visible.begin(), bvh_visible.end());
+        if (!std::equal(bvh_visible.begin(), bvh_visible.end(), visible.begin(), visible.end())) {
+            std::cerr << "the BVH disagrees with the flat culler on which objects are visible\n";
+            return 1;
+        }
+
+        std::cout << no_objects << " objects (" << no_visible << " visible), objects culled per ms:"
+                  << " scalar " << static_cast<size_t>(scalar)
+                  << ", " << cull_kernel_name() << " " << static_cast<size_t>(simd)
+                  << ", " << cull_kernel_name() << " x" << jobs.no_threads() << " threads " << static_cast<size_t>(threaded)
+                  << ", bvh " << static_cast<size_t>(hierarchical)
+                  << " (full refit " << static_cast<size_t>(refit) << ")\n";
+    }
+
+    return 0;
+}
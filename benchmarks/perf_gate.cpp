@@ -0,0 +1,511 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+//checking the benchmarks haven't got slower
+// - runs every benchmark in the baseline file a number of times (headless, each writing a json report, see BenchmarkReport)
+// - takes the median and median absolute deviation (MAD) of every metric over the runs
+// - a metric has regressed if its median is worse than the baseline by more than its tolerance (a fraction of the baseline)
+//   and by more than the noise between runs (3 standard deviations, estimated from the MAD)
+// - exits with 1 if anything regressed, a benchmark failed or a metric has no baseline, so it can be used as a gate (see the check_performance target)
+//   > with --allow-missing-baseline metrics without a baseline are only reported (e.g. for a benchmark that was just added)
+// - with --update the baseline values are replaced with the medians measured (the tolerances are kept)
+//   > nothing is written, and it exits with 1, if a benchmark failed or a metric is missing
+// - usage: perf_gate <baseline.json> [--runs n] [--bin-dir dir] [--update] [--allow-missing-baseline]
+//
+//the baseline file
+//  {"runs": 5, "benchmarks": [{"name": "draw_calls", "command": "draw_call_benchmark --frames 20",
+//                              "metrics": {"10000 objects/record_ms": {"baseline": 1.5, "tolerance": 0.15, "better": "lower"}, ...}}, ...]}
+// - metrics are "<result name>/<metric name>" from the benchmark's report
+// - a baseline of null hasn't been measured yet, run the update_performance_baseline target on the reference machine to fill it in
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    //just enough json for the baseline and the benchmark reports
+    struct Json {
+        enum class Type {null, boolean, number, string, array, object};
+        Type type = Type::null;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<Json> array;
+        std::vector<std::pair<std::string, Json>> object;   //in the order they were written
+
+        [[nodiscard]] const Json* find(const std::string& key) const {
+            for (const auto& [k, v] : object) {
+                if (k == key) {
+                    return &v;
+                }
+            }
+            return nullptr;
+        }
+        [[nodiscard]] Json* find(const std::string& key) {
+            return const_cast<Json*>(static_cast<const Json&>(*this).find(key));
+        }
+
+        [[nodiscard]] const Json& at(const std::string& key) const {
+            const auto value = find(key);
+            if (value == nullptr) {
+                throw std::runtime_error("missing \"" + key + "\"");
+            }
+            return *value;
+        }
+        [[nodiscard]] Json& at(const std::string& key) {
+            return const_cast<Json&>(static_cast<const Json&>(*this).at(key));
+        }
+
+        static Json make_number(const double value) {
+            Json json;
+            json.type = Type::number;
+            json.number = value;
+            return json;
+        }
+    };
+
+    class JsonParser {
+    public:
+        explicit JsonParser(std::string text) : s(std::move(text)) {}
+
+        Json parse() {
+            auto value = parse_value();
+            skip_space();
+            if (pos != s.size()) {
+                error("unexpected characters after the end");
+            }
+            return value;
+        }
+
+    private:
+        [[noreturn]] void error(const std::string& what) const {
+            throw std::runtime_error("invalid json at character " + std::to_string(pos) + ": " + what);
+        }
+
+        void skip_space() {
+            while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) {
+                pos++;
+            }
+        }
+
+        void expect(const char c) {
+            skip_space();
+            if (pos >= s.size() || s[pos] != c) {
+                error(std::string("expected '") + c + "'");
+            }
+            pos++;
+        }
+
+        bool consume(const std::string_view word) {
+            if (s.compare(pos, word.size(), word) == 0) {
+                pos += word.size();
+                return true;
+            }
+            return false;
+        }
+
+        Json parse_value() {
+            skip_space();
+            if (pos >= s.size()) {
+                error("unexpected end");
+            }
+            Json value;
+            const char c = s[pos];
+            if (c == '{') {
+                value.type = Json::Type::object;
+                pos++;
+                skip_space();
+                if (pos < s.size() && s[pos] == '}') {
+                    pos++;
+                    return value;
+                }
+                while (true) {
+                    skip_space();
+                    auto key = parse_string();
+                    expect(':');
+                    value.object.emplace_back(std::move(key), parse_value());
+                    skip_space();
+                    if (pos < s.size() && s[pos] == ',') {
+                        pos++;
+                        continue;
+                    }
+                    expect('}');
+                    return value;
+                }
+            }
+            if (c == '[') {
+                value.type = Json::Type::array;
+                pos++;
+                skip_space();
+                if (pos < s.size() && s[pos] == ']') {
+                    pos++;
+                    return value;
+                }
+                while (true) {
+                    value.array.push_back(parse_value());
+                    skip_space();
+                    if (pos < s.size() && s[pos] == ',') {
+                        pos++;
+                        continue;
+                    }
+                    expect(']');
+                    return value;
+                }
+            }
+            if (c == '"') {
+                value.type = Json::Type::string;
+                value.string = parse_string();
+                return value;
+            }
+            if (consume("true")) {
+                value.type = Json::Type::boolean;
+                value.boolean = true;
+                return value;
+            }
+            if (consume("false")) {
+                value.type = Json::Type::boolean;
+                return value;
+            }
+            if (consume("null")) {
+                return value;
+            }
+
+            //a number
+            const char* start = s.c_str() + pos;
+            char* end = nullptr;
+            value.type = Json::Type::number;
+            value.number = std::strtod(start, &end);
+            if (end == start) {
+                error("unexpected character");
+            }
+            pos += static_cast<size_t>(end - start);
+            return value;
+        }
+
+        //only the escapes BenchmarkReport writes (and \n, \t) are understood
+        std::string parse_string() {
+            if (pos >= s.size() || s[pos] != '"') {
+                error("expected a string");
+            }
+            pos++;
+            std::string result;
+            while (pos < s.size() && s[pos] != '"') {
+                if (s[pos] == '\\' && pos + 1 < s.size()) {
+                    pos++;
+                    result += s[pos] == 'n' ? '\n' : s[pos] == 't' ? '\t' : s[pos];
+                } else {
+                    result += s[pos];
+                }
+                pos++;
+            }
+            if (pos >= s.size()) {
+                error("unterminated string");
+            }
+            pos++;
+            return result;
+        }
+
+        std::string s;
+        size_t pos = 0;
+    };
+
+    Json read_json(const std::filesystem::path& file) {
+        std::ifstream in(file);
+        if (!in) {
+            throw std::runtime_error("failed to open " + file.string());
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        try {
+            return JsonParser(text.str()).parse();
+        } catch (const std::exception& e) {
+            throw std::runtime_error(file.string() + ": " + e.what());
+        }
+    }
+
+    void write_string(std::ostream& out, const std::string& s) {
+        out << '"';
+        for (const char c : s) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+    //every metric is kept on one line so the baseline stays readable
+    enum class Layout {normal, metrics, single_line};
+
+    void write_json(std::ostream& out, const Json& value, const int indent, const Layout layout = Layout::normal) {
+        const std::string pad(static_cast<size_t>(indent) * 2, ' ');
+        const std::string inner(static_cast<size_t>(indent + 1) * 2, ' ');
+        switch (value.type) {
+            case Json::Type::null:
+                out << "null";
+                break;
+            case Json::Type::boolean:
+                out << (value.boolean ? "true" : "false");
+                break;
+            case Json::Type::number:
+                out << value.number;
+                break;
+            case Json::Type::string:
+                write_string(out, value.string);
+                break;
+            case Json::Type::array:
+                out << "[";
+                for (size_t i = 0; i < value.array.size(); i++) {
+                    out << (i == 0 ? "\n" : ",\n") << inner;
+                    write_json(out, value.array[i], indent + 1);
+                }
+                out << "\n" << pad << "]";
+                break;
+            case Json::Type::object:
+                out << "{";
+                for (size_t i = 0; i < value.object.size(); i++) {
+                    const auto& [key, child] = value.object[i];
+                    if (layout == Layout::single_line) {
+                        out << (i == 0 ? "" : ", ");
+                    } else {
+                        out << (i == 0 ? "\n" : ",\n") << inner;
+                    }
+                    write_string(out, key);
+                    out << ": ";
+                    const auto child_layout = key == "metrics" ? Layout::metrics : layout == Layout::normal ? Layout::normal : Layout::single_line;
+                    write_json(out, child, indent + 1, child_layout);
+                }
+                if (layout != Layout::single_line) {
+                    out << "\n" << pad;
+                }
+                out << "}";
+                break;
+        }
+    }
+
+    double median(std::vector<double> samples) {
+        std::sort(samples.begin(), samples.end());
+        const size_t n = samples.size();
+        return n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    }
+
+    //median absolute deviation -- how spread out the samples are, ignoring outliers
+    double mad(const std::vector<double>& samples, const double centre) {
+        std::vector<double> deviations;
+        deviations.reserve(samples.size());
+        for (const auto sample : samples) {
+            deviations.push_back(std::abs(sample - centre));
+        }
+        return median(std::move(deviations));
+    }
+
+    //the metrics of a report, keyed by "<result name>/<metric name>"
+    std::map<std::string, double> report_metrics(const Json& report) {
+        std::map<std::string, double> metrics;
+        for (const auto& result : report.at("results").array) {
+            const auto& name = result.at("name").string;
+            for (const auto& [metric, value] : result.at("metrics").object) {
+                if (value.type == Json::Type::number) {
+                    metrics[name + "/" + metric] = value.number;
+                }
+            }
+        }
+        return metrics;
+    }
+
+    struct Options {
+        std::filesystem::path baseline_file;
+        std::optional<unsigned> runs;
+        std::filesystem::path bin_dir = ".";
+        bool update = false;
+        bool allow_missing_baseline = false;
+    };
+
+    Options parse_options(const int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (arg == "--update") {
+                options.update = true;
+            } else if (arg == "--allow-missing-baseline") {
+                options.allow_missing_baseline = true;
+            } else if (arg == "--runs" && i + 1 < argc) {
+                options.runs = static_cast<unsigned>(std::max(1ul, std::strtoul(argv[++i], nullptr, 10)));
+            } else if (arg == "--bin-dir" && i + 1 < argc) {
+                options.bin_dir = argv[++i];
+            } else if (options.baseline_file.empty() && arg.rfind("--", 0) != 0) {
+                options.baseline_file = arg;
+            } else {
+                throw std::runtime_error("unknown option " + arg);
+            }
+        }
+        if (options.baseline_file.empty()) {
+            throw std::runtime_error("usage: perf_gate <baseline.json> [--runs n] [--bin-dir dir] [--update] [--allow-missing-baseline]");
+        }
+        return options;
+    }
+
+    //how a metric compared to its baseline
+    enum class Status {ok, regressed, improved, no_baseline, missing};
+
+    const char* status_name(const Status status) {
+        switch (status) {
+            case Status::ok:            return "ok";
+            case Status::regressed:     return "REGRESSED";
+            case Status::improved:      return "improved";
+            case Status::no_baseline:   return "NO BASELINE";
+            case Status::missing:       return "MISSING";
+        }
+        return "";
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parse_options(argc, argv);
+        auto baseline = read_json(options.baseline_file);
+
+        unsigned runs = 5;
+        if (const auto r = baseline.find("runs")) {
+            runs = static_cast<unsigned>(std::max(1.0, r->number));
+        }
+        runs = options.runs.value_or(runs);
+
+        bool failed = false;
+        bool incomplete = false;    //a benchmark failed or a metric is missing, so there is nothing to update the baseline with
+        for (auto& benchmark : baseline.at("benchmarks").array) {
+            const auto& name = benchmark.at("name").string;
+            const auto& command = benchmark.at("command").string;
+
+            //the executable is the first word, it is looked for in the bin directory
+            const auto space = command.find(' ');
+            const auto executable = options.bin_dir / command.substr(0, space);
+            const auto arguments = space == std::string::npos ? std::string() : command.substr(space);
+            const auto report_file = std::filesystem::temp_directory_path() / ("perf_gate_" + name + ".json");
+
+            std::cout << "running " << name << " " << runs << " times\n" << std::flush;
+            std::map<std::string, std::vector<double>> samples;
+            bool benchmark_failed = false;
+            for (unsigned run = 0; run < runs; run++) {
+                std::filesystem::remove(report_file);
+                const auto full_command = "\"" + executable.string() + "\"" + arguments + " --json \"" + report_file.string() + "\"";
+                if (std::system(full_command.c_str()) != 0) {
+                    std::cerr << name << " failed: " << full_command << "\n";
+                    benchmark_failed = true;
+                    break;
+                }
+                for (const auto& [metric, value] : report_metrics(read_json(report_file))) {
+                    samples[metric].push_back(value);
+                }
+            }
+            std::filesystem::remove(report_file);
+            if (benchmark_failed) {
+                failed = true;
+                incomplete = true;
+                continue;
+            }
+
+            std::cout << std::left << std::setw(44) << name << std::right << std::setw(12) << "baseline" << std::setw(12) << "median"
+                      << std::setw(10) << "MAD" << std::setw(10) << "change" << "  status\n";
+            for (auto& [metric, limits] : benchmark.at("metrics").object) {
+                const auto* baseline_value = limits.find("baseline");
+                const double tolerance = limits.at("tolerance").number;
+                const auto better = limits.find("better");
+                const bool higher_is_better = better != nullptr && better->string == "higher";
+
+                const auto found = samples.find(metric);
+                //a metric missing from some runs (e.g. the GPU time without timestamps) can't be compared
+                if (found == samples.end() || found->second.size() != runs) {
+                    std::cout << std::left << std::setw(44) << metric << std::right << std::setw(54) << "" << "  " << status_name(Status::missing) << "\n";
+                    failed = true;
+                    incomplete = true;
+                    continue;
+                }
+
+                const double m = median(found->second);
+                const double spread = mad(found->second, m);
+
+                Status status = Status::no_baseline;
+                double change = 0.0;   //percent
+                if (baseline_value != nullptr && baseline_value->type == Json::Type::number) {
+                    const double base = baseline_value->number;
+                    //how much worse than the baseline (negative is better)
+                    const double worse = higher_is_better ? base - m : m - base;
+                    const double allowed = std::abs(base) * tolerance;
+                    const double noise = 3.0 * 1.4826 * spread;     //1.4826 * MAD estimates the standard deviation of normally distributed samples
+                    change = std::abs(base) > 0.0 ? (m - base) / std::abs(base) * 100.0 : 0.0;
+
+                    if (worse > allowed && worse > noise) {
+                        status = Status::regressed;
+                        failed = true;
+                    } else if (-worse > allowed && -worse > noise) {
+                        status = Status::improved;
+                    } else {
+                        status = Status::ok;
+                    }
+                }
+                //otherwise a baseline that was never measured would let every check pass (--update is what measures it)
+                if (status == Status::no_baseline && !options.allow_missing_baseline && !options.update) {
+                    failed = true;
+                }
+
+                std::cout << std::left << std::setw(44) << metric << std::right << std::fixed << std::setprecision(3);
+                if (status == Status::no_baseline) {
+                    std::cout << std::setw(12) << "-" << std::setw(12) << m << std::setw(10) << spread << std::setw(10) << "-";
+                } else {
+                    std::cout << std::setw(12) << baseline_value->number << std::setw(12) << m << std::setw(10) << spread
+                              << std::setw(9) << std::setprecision(1) << change << "%";
+                }
+                std::cout << "  " << status_name(status) << "\n";
+
+                if (options.update) {
+                    if (baseline_value != nullptr) {
+                        limits.find("baseline")->type = Json::Type::number;
+                        limits.find("baseline")->number = m;
+                    } else {
+                        limits.object.insert(limits.object.begin(), {"baseline", Json::make_number(m)});
+                    }
+                }
+            }
+        }
+
+        if (options.update) {
+            //regressions are what --update is for (accepting the new numbers), but a partial baseline would hide the broken benchmarks
+            if (incomplete) {
+                std::cout << "not updating " << options.baseline_file.string() << ", a benchmark failed or a metric is missing\n";
+                return EXIT_FAILURE;
+            }
+            std::ofstream out(options.baseline_file);
+            out << std::setprecision(6);
+            write_json(out, baseline, 0);
+            out << "\n";
+            if (!out) {
+                throw std::runtime_error("failed to write " + options.baseline_file.string());
+            }
+            std::cout << "updated " << options.baseline_file.string() << "\n";
+            return EXIT_SUCCESS;
+        }
+
+        if (failed) {
+            std::cout << "performance check failed\n";
+            return EXIT_FAILURE;
+        }
+        std::cout << "performance check passed\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
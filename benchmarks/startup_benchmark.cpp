@@ -0,0 +1,159 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+//benchmark for how long the renderer takes to start
+// - starts the renderer headless a number of times, timing each phase of Renderer::initVulkan (see StartupTimings) and the first frame
+// - every run is a cold start (no pipeline cache) followed by a warm start (using the cache the cold start saved)
+// - the pipeline cache is kept in a temporary file (see pipeline_cache_variable) so the real one is never touched
+// - the driver may have its own shader cache that this can't clear, so cold starts can still be faster after the first run
+// - must be run from the build directory like Vulkan_engine (the textures are loaded from ../textures)
+// - usage: startup_benchmark [--runs n] [--json file]
+
+#include "benchmark_report.hpp"
+#include "../renderer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr const char* first_frame_phase = "first frame";
+
+    struct Options {
+        unsigned runs = 5;
+        std::string json_file;  //not written if empty
+    };
+
+    Options parse_options(const int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                throw std::runtime_error("missing value for " + arg);
+            }
+            const std::string value = argv[++i];
+
+            if (arg == "--runs") {
+                char* end = nullptr;
+                options.runs = static_cast<unsigned>(std::strtoul(value.c_str(), &end, 10));
+                if (value.empty() || *end != '\0' || options.runs == 0) {
+                    throw std::runtime_error("expected a positive number, got '" + value + "'");
+                }
+            } else if (arg == "--json") {
+                options.json_file = value;
+            } else {
+                throw std::runtime_error("unknown option " + arg);
+            }
+        }
+        return options;
+    }
+
+    //the times of every phase over all the runs of one kind of start
+    struct StartupSamples {
+        std::vector<std::string> phases;    //in the order they ran
+        std::map<std::string, std::vector<double>> ms;
+        std::vector<double> total_ms;
+        unsigned cache_hits = 0;
+
+        void add(const std::string& phase, const double time) {
+            auto& samples = ms[phase];
+            if (samples.empty()) {
+                phases.push_back(phase);
+            }
+            samples.push_back(time);
+        }
+    };
+
+    //starting the renderer, drawing one frame and shutting it down again
+    void start_renderer(StartupSamples& samples) {
+        Window window;
+        Renderer app(window);
+        window.makeHeadless(window.window_width, window.window_height);
+
+        app.initVulkan();
+
+        //the first frame also pays for anything created lazily
+        const auto frame_start = std::chrono::steady_clock::now();
+        app.drawFrame(app.simulate());
+        app.endDrawFrame();
+        const double first_frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start).count();
+
+        const auto& timings = app.get_startup_timings();
+        for (const auto& phase : timings.phases) {
+            samples.add(phase.name, phase.ms);
+        }
+        samples.add(first_frame_phase, first_frame_ms);
+        samples.total_ms.push_back(timings.total_ms() + first_frame_ms);
+        samples.cache_hits += timings.pipeline_cache_hit ? 1 : 0;
+
+        app.cleanup();  //saves the pipeline cache for the next (warm) start
+        window.cleanup();
+    }
+
+    //phase names as json keys (e.g. "swap chain" -> "swap_chain_ms")
+    std::string metric_name(std::string phase) {
+        for (auto& c : phase) {
+            if (c == ' ') {
+                c = '_';
+            }
+        }
+        return phase + "_ms";
+    }
+
+    void report_samples(BenchmarkReport& report, const std::string& name, const StartupSamples& samples, const unsigned runs) {
+        report.add_result(name);
+        report.add_metric("total_ms", median(samples.total_ms));
+        report.add_metric("pipeline_cache_hits", static_cast<double>(samples.cache_hits));
+        for (const auto& phase : samples.phases) {
+            report.add_metric(metric_name(phase), median(samples.ms.at(phase)));
+        }
+
+        std::cout << name << " start (median of " << runs << ", pipeline cache used " << samples.cache_hits << " times)\n";
+        std::cout << std::fixed << std::setprecision(2);
+        for (const auto& phase : samples.phases) {
+            std::cout << "  " << std::left << std::setw(20) << phase << std::right << std::setw(10) << median(samples.ms.at(phase)) << " ms\n";
+        }
+        std::cout << "  " << std::left << std::setw(20) << "total" << std::right << std::setw(10) << median(samples.total_ms) << " ms\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parse_options(argc, argv);
+
+        //keeping the pipeline cache somewhere it can be deleted
+        const auto cache_file = std::filesystem::temp_directory_path() / "vulkan_engine_startup_benchmark_cache.bin";
+#ifdef _WIN32
+        _putenv_s(pipeline_cache_variable, cache_file.string().c_str());
+#else
+        setenv(pipeline_cache_variable, cache_file.c_str(), 1);
+#endif
+
+        StartupSamples cold, warm;
+        for (unsigned run = 0; run < options.runs; run++) {
+            std::filesystem::remove(cache_file);
+            start_renderer(cold);
+            start_renderer(warm);
+        }
+        std::filesystem::remove(cache_file);
+
+        BenchmarkReport report("startup");
+        report_samples(report, "cold", cold, options.runs);
+        report_samples(report, "warm", warm, options.runs);
+
+        if (!options.json_file.empty()) {
+            report.write(options.json_file);
+            std::cout << "wrote " << options.json_file << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+//micro-benchmark for working out the object matrices
+// - checks every SIMD kernel the engine was compiled with against the scalar one, and then reports how many objects each can do per millisecond
+// - the renderer only has a handful of objects so never gets past the scalar tail of the SIMD kernels, this is what tests them
+// - usage: transform_benchmark [no_objects ...]
+
+#include "../transforms.hpp"
+#include "../job_system.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string_view>
+
+namespace {
+    //randomly placed objects spinning about random axes
+    Transforms random_transforms(const size_t no_objects) {
+        std::mt19937 rng(1234);     //fixed seed so runs are comparable
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> speed(-4.0f, 4.0f);
+        std::uniform_real_distribution<float> scale(0.25f, 2.0f);
+
+        Transforms transforms;
+        transforms.reserve(no_objects);
+        for (size_t i = 0; i < no_objects; i++) {
+            glm::vec3 a(axis(rng), axis(rng), axis(rng));
+            if (glm::dot(a, a) < 1e-4f) {
+                a = glm::vec3(0.0f, 0.0f, 1.0f);    //too short to normalise
+            }
+            transforms.add(glm::vec3(position(rng), position(rng), position(rng)), a, speed(rng), scale(rng));
+        }
+        return transforms;
+    }
+
+    //the largest difference between any element of the matrices, relative to the size of the element
+    float max_difference(const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b) {
+        float difference = 0.0f;
+        for (size_t i = 0; i < a.size(); i++) {
+            for (int col = 0; col < 4; col++) {
+                for (int row = 0; row < 4; row++) {
+                    const float expected = a[i][col][row];
+                    difference = std::max(difference, std::abs(b[i][col][row] - expected) / std::max(1.0f, std::abs(expected)));
+                }
+            }
+        }
+        return difference;
+    }
+
+    //runs `update' repeatedly for at least min_time and returns the number of objects done per millisecond
+    double objects_per_ms(const size_t no_objects, const std::function<void()>& update) {
+        constexpr auto min_time = std::chrono::milliseconds(250);
+
+        update(); //warming the caches
+
+        size_t iterations = 0;
+        const auto start = std::chrono::steady_clock::now();
+        auto now = start;
+        while (now - start < min_time) {
+            update();
+            iterations++;
+            now = std::chrono::steady_clock::now();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(now - start).count();
+        return static_cast<double>(no_objects * iterations) / ms;
+    }
+
+    using Kernel = void(*)(const Transforms&, double, const glm::mat4&, size_t, size_t, glm::mat4*, glm::mat4*);
+    struct NamedKernel {
+        std::string_view name;
+        Kernel kernel;
+    };
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> object_counts;
+    for (int i = 1; i < argc; i++) {
+        object_counts.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (object_counts.empty()) {
+        object_counts = {1000, 100000, 1000000};
+    }
+
+    std::vector<NamedKernel> kernels;
+#ifdef __SSE2__
+    kernels.push_back({"sse2", transform_range_sse});
+#endif
+#ifdef __AVX2__
+    kernels.push_back({"avx2", transform_range_avx2});
+#endif
+
+    //same camera setup as the renderer
+    const auto view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    auto proj = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    proj[1][1] *= -1;
+    const auto view_proj = proj * view;
+
+    //the SIMD sin and cos are only accurate for small angles, so checking the angles are wrapped properly after the program has run for a long time
+    // - 1e7s is about 4 months
+    constexpr double check_times[] = {0.0, 1.0, 5400.0, 1e7};
+    constexpr float tolerance = 1e-4f;
+
+    JobSystem jobs;
+    const TransformUpdater updater(jobs);
+
+    for (const auto no_objects : object_counts) {
+        const auto transforms = random_transforms(no_objects);
+        std::vector<glm::mat4> expected_models(no_objects), expected_mvps(no_objects);
+        std::vector<glm::mat4> models(no_objects), mvps(no_objects);
+
+        for (const auto time : check_times) {
+            transform_range_scalar(transforms, time, view_proj, 0, no_objects, expected_models.data(), expected_mvps.data());
+            for (const auto& [name, kernel] : kernels) {
+                //starting part way in so the kernel has a scalar head and tail to deal with too
+                const size_t begin = std::min<size_t>(3, no_objects);
+                std::copy(expected_models.begin(), expected_models.begin() + static_cast<long>(begin), models.begin());
+                std::copy(expected_mvps.begin(), expected_mvps.begin() + static_cast<long>(begin), mvps.begin());
+                kernel(transforms, time, view_proj, begin, no_objects, models.data(), mvps.data());
+
+                const float difference = std::max(max_difference(expected_models, models), max_difference(expected_mvps, mvps));
+                if (difference > tolerance) {
+                    std::cerr << "the " << name << " kernel disagrees with the scalar kernel by " << difference << " at time " << time << "s\n";
+                    return 1;
+                }
+            }
+        }
+
+        const double time = 1.0;
+        std::cout << no_objects << " objects, matrices (model and mvp) per ms:";
+        std::cout << " scalar " << static_cast<size_t>(objects_per_ms(no_objects, [&] {
+            transform_range_scalar(transforms, time, view_proj, 0, no_objects, models.data(), mvps.data());
+        }));
+        for (const auto& [name, kernel] : kernels) {
+            std::cout << ", " << name << " " << static_cast<size_t>(objects_per_ms(no_objects, [&] {
+                kernel(transforms, time, view_proj, 0, no_objects, models.data(), mvps.data());
+            }));
+        }
+        std::cout << ", " << transform_kernel_name() << " x" << jobs.no_threads() << " threads " << static_cast<size_t>(objects_per_ms(no_objects, [&] {
+            updater.update(transforms, time, view_proj, models.data(), mvps.data());
+        })) << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+//benchmark for uploading assets to the GPU
+// - pushes many vertex buffers, index buffers and textures of each size through VertexBuffer::setup, IndexBuffer::setup and Texture::setup
+// - everything uploaded for a size is kept until the size is finished (like loading a level), then destroyed
+// - reports MB/s, uploads/s, the device memory allocations made per upload and the peak host memory
+// - runs headless so it works with a software implementation (e.g. lavapipe) on a machine without a GPU
+// - usage: upload_benchmark [--count n] [--json file]
+
+#include "benchmark_device.hpp"
+#include "benchmark_report.hpp"
+
+#include "../buffer.hpp"
+#include "../vertex_buffer.hpp"
+#include "../index_buffer.hpp"
+#include "../texture.hpp"
+#include "../vertex.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr double bytes_per_mb = 1024.0 * 1024.0;
+    //each size uploads about this much in total (so the small sizes are still timed over many uploads)
+    constexpr size_t bytes_per_size = size_t{256} * 1024 * 1024;
+    constexpr size_t max_uploads = 2000;
+    constexpr size_t min_uploads = 4;
+
+    struct Options {
+        size_t count = 0;       //the number of uploads for each size (0 picks it from the size)
+        std::string json_file;  //not written if empty
+    };
+
+    Options parse_options(const int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                throw std::runtime_error("missing value for " + arg);
+            }
+            const std::string value = argv[++i];
+
+            if (arg == "--count") {
+                char* end = nullptr;
+                options.count = std::strtoul(value.c_str(), &end, 10);
+                if (value.empty() || *end != '\0' || options.count == 0) {
+                    throw std::runtime_error("expected a positive number, got '" + value + "'");
+                }
+            } else if (arg == "--json") {
+                options.json_file = value;
+            } else {
+                throw std::runtime_error("unknown option " + arg);
+            }
+        }
+        return options;
+    }
+
+    //one kind of upload
+    // - upload makes (and keeps) the next resource, release destroys all of them
+    struct UploadCase {
+        std::string name;
+        size_t bytes;   //per upload
+        std::function<void()> upload;
+        std::function<void()> release;
+    };
+
+    //the vertices, indices or pixels every upload of a case copies from
+    // - the buffers keep a reference to their data so it must outlive them
+    template <typename T>
+    std::shared_ptr<std::vector<T>> make_data(const size_t bytes) {
+        auto data = std::make_shared<std::vector<T>>(std::max<size_t>(1, bytes / sizeof(T)));
+        //not all zeros, in case the driver does anything clever with them
+        auto* raw = reinterpret_cast<unsigned char*>(data->data());
+        for (size_t i = 0; i < data->size() * sizeof(T); i++) {
+            raw[i] = static_cast<unsigned char>(i * 31);
+        }
+        return data;
+    }
+
+    template <typename T>
+    UploadCase vertex_buffer_case(BenchmarkDevice& device, const size_t bytes) {
+        auto data = make_data<T>(bytes);
+        auto buffers = std::make_shared<std::vector<std::unique_ptr<VertexBuffer<T>>>>();
+        return {"vertex buffer " + std::to_string(bytes / 1024) + " KiB", data->size() * sizeof(T),
+                [&device, data, buffers] {
+                    buffers->push_back(std::make_unique<VertexBuffer<T>>(device.logical_device, device.command_pool, *data));
+                    buffers->back()->setup();
+                },
+                [buffers] {
+                    for (auto& buffer : *buffers) {
+                        buffer->cleanup();
+                    }
+                    buffers->clear();
+                }};
+    }
+
+    UploadCase index_buffer_case(BenchmarkDevice& device, const size_t bytes) {
+        auto data = make_data<uint32_t>(bytes);
+        auto buffers = std::make_shared<std::vector<std::unique_ptr<IndexBuffer<uint32_t>>>>();
+        return {"index buffer " + std::to_string(bytes / 1024) + " KiB", data->size() * sizeof(uint32_t),
+                [&device, data, buffers] {
+                    buffers->push_back(std::make_unique<IndexBuffer<uint32_t>>(device.logical_device, device.command_pool, *data));
+                    buffers->back()->setup();
+                },
+                [buffers] {
+                    for (auto& buffer : *buffers) {
+                        buffer->cleanup();
+                    }
+                    buffers->clear();
+                }};
+    }
+
+    UploadCase texture_case(BenchmarkDevice& device, const unsigned size) {
+        const size_t bytes = size_t{size} * size * 4;
+        auto pixels = make_data<unsigned char>(bytes);
+        auto textures = std::make_shared<std::vector<std::unique_ptr<Texture>>>();
+        return {"texture " + std::to_string(size) + "x" + std::to_string(size), bytes,
+                [&device, pixels, textures, size] {
+                    textures->push_back(std::make_unique<Texture>(device.logical_device, device.command_pool, ""));
+                    textures->back()->setup(pixels->data(), size, size);
+                },
+                [textures] {
+                    for (auto& texture : *textures) {
+                        texture->cleanup();
+                    }
+                    textures->clear();
+                }};
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parse_options(argc, argv);
+
+        BenchmarkDevice device;
+        device.setup(64, 64);   //nothing is rendered, so the size doesn't matter
+
+        BenchmarkReport report("uploads");
+        report.device = device.device_name();
+        std::cout << "device: " << report.device << "\n";
+        std::cout << std::setw(28) << "upload" << std::setw(10) << "count" << std::setw(12) << "MB/s" << std::setw(14) << "uploads/s"
+                  << std::setw(18) << "allocs/upload" << std::setw(18) << "peak host (MB)" << "\n";
+
+        //from a single mesh up to a large streamed level chunk
+        std::vector<UploadCase> cases;
+        for (const size_t kib : {4u, 64u, 1024u, 16384u}) {
+            cases.push_back(vertex_buffer_case<Vertex::TWOD_VT>(device, kib * 1024));
+        }
+        for (const size_t kib : {4u, 64u, 1024u, 16384u}) {
+            cases.push_back(index_buffer_case(device, kib * 1024));
+        }
+        for (const unsigned size : {64u, 256u, 1024u, 2048u}) {
+            cases.push_back(texture_case(device, size));
+        }
+
+        for (auto& upload_case : cases) {
+            const size_t count = options.count != 0 ? options.count : std::clamp(bytes_per_size / upload_case.bytes, min_uploads, max_uploads);
+
+            const auto allocations_before = device_memory_stats().allocations;
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < count; i++) {
+                upload_case.upload();
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const auto allocations = device_memory_stats().allocations - allocations_before;
+            const double peak_mb = static_cast<double>(peak_host_memory()) / bytes_per_mb;
+
+            upload_case.release();
+
+            const double mb = static_cast<double>(upload_case.bytes * count) / bytes_per_mb;
+            const double mb_per_s = mb / seconds;
+            const double uploads_per_s = static_cast<double>(count) / seconds;
+            const double allocations_per_upload = static_cast<double>(allocations) / static_cast<double>(count);
+
+            report.add_result(upload_case.name);
+            report.add_metric("bytes", static_cast<double>(upload_case.bytes));
+            report.add_metric("uploads", static_cast<double>(count));
+            report.add_metric("mb_per_s", mb_per_s);
+            report.add_metric("uploads_per_s", uploads_per_s);
+            report.add_metric("device_allocations", static_cast<double>(allocations));
+            report.add_metric("peak_host_mb", peak_mb);
+
+            std::cout << std::fixed << std::setprecision(1) << std::setw(28) << upload_case.name << std::setw(10) << count << std::setw(12) << mb_per_s
+                      << std::setw(14) << uploads_per_s << std::setw(18) << allocations_per_upload << std::setw(18) << peak_mb << "\n";
+        }
+
+        device.cleanup();
+
+        if (!options.json_file.empty()) {
+            report.write(options.json_file);
+            std::cout << "wrote " << options.json_file << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -3,8 +3,13 @@
 //
 
 #include "buffer.hpp"
+#include <atomic>
 #include <stdexcept>
 
+//counted by allocate_device_memory
+static std::atomic<uint64_t> device_allocations{0};
+static std::atomic<uint64_t> device_allocated_bytes{0};
+
 
 //need to match the memory requirements of the buffer with those offered by the graphics cards
 //to find the right type of memory to use
@@ -111,6 +116,20 @@ void SingleTimeCommandBuffer::execute_recording() {
 
 
 
+VkResult allocate_device_memory(LogicalDevice &device, const VkMemoryAllocateInfo& allocInfo, VkDeviceMemory& memory) {
+    const auto result = vkAllocateMemory(device.get_device(), &allocInfo, nullptr, &memory);   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/vkAllocateMemory.html
+    if (result == VK_SUCCESS) {
+        device_allocations.fetch_add(1, std::memory_order_relaxed);
+        device_allocated_bytes.fetch_add(allocInfo.allocationSize, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+DeviceMemoryStats device_memory_stats() {
+    return {device_allocations.load(std::memory_order_relaxed), device_allocated_bytes.load(std::memory_order_relaxed)};
+}
+
+
 //size is size in bytes
 //very few of these buffers should be created. On high end graphics cards there is a maximum of around 4000 possible.
 //Should create one big buffers and use offsets to access the data inside it
@@ -146,7 +165,7 @@ void create_buffer(LogicalDevice &device, VkDeviceSize size, VkBufferUsageFlags
     allocInfo.memoryTypeIndex = findMemoryType(device.physical_device, memRequirements.memoryTypeBits, properties); //index of the memory type
     //using the find memory type helper function to find the index of the best memory type
 
-    if (vkAllocateMemory(device.get_device(), &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
+    if (allocate_device_memory(device, allocInfo, bufferMemory) != VK_SUCCESS) {
         throw std::runtime_error("failed to allocate buffer memory!");
     }
 
@@ -34,6 +34,19 @@ private:
 //last 2 parameters get written to
 void create_buffer(LogicalDevice &device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
 
+//allocating device memory and counting the allocation (see device_memory_stats)
+// - every vkAllocateMemory in the engine goes through here
+VkResult allocate_device_memory(LogicalDevice &device, const VkMemoryAllocateInfo& allocInfo, VkDeviceMemory& memory);
+
+//the device memory allocated since the program started (freeing is not counted)
+// - every allocation is a separate allocation in the driver and counts towards the maxMemoryAllocationCount limit (which can be as low as 4096)
+// - can be read from any thread
+struct DeviceMemoryStats {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+[[nodiscard]] DeviceMemoryStats device_memory_stats();
+
 //helper function to copy data from one buffer to another
 //command pool is to bool to allocate the copying commands from
 void copyBuffer(LogicalDevice &device, CommandPool& command_pool, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
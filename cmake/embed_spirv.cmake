@@ -0,0 +1,46 @@
+# Turns compiled SPIR-V files into a C++ header of constexpr uint32_t arrays
+# - run with cmake -P so it can be used as a build step
+# - OUTPUT is the header to write, SPIRV_FILES is a ;-separated list of .spv files
+#   > each array is named after its file (spv_<file name without .spv>)
+# - also writes a table of every array so shaders can be looked up by file name
+
+if(NOT DEFINED OUTPUT OR NOT DEFINED SPIRV_FILES)
+    message(FATAL_ERROR "embed_spirv.cmake needs OUTPUT and SPIRV_FILES")
+endif()
+
+set(arrays "")
+set(entries "")
+foreach(spirv_file IN LISTS SPIRV_FILES)
+    get_filename_component(file_name ${spirv_file} NAME)
+    get_filename_component(name ${spirv_file} NAME_WE)
+    string(MAKE_C_IDENTIFIER "spv_${name}" identifier)
+
+    file(READ ${spirv_file} hex HEX)
+    string(LENGTH "${hex}" hex_length)
+    math(EXPR remainder "${hex_length} % 8")
+    if(hex_length EQUAL 0 OR NOT remainder EQUAL 0)
+        message(FATAL_ERROR "${spirv_file} is not valid SPIR-V (size must be a multiple of 4 bytes)")
+    endif()
+
+    # SPIR-V is a stream of little endian 32 bit words, so reversing the bytes of each word
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])" "0x\\4\\3\\2\\1," words "${hex}")
+    # splitting into lines so the header isn't one enormous line
+    string(REGEX REPLACE "(0x[0-9a-f]+,0x[0-9a-f]+,0x[0-9a-f]+,0x[0-9a-f]+,0x[0-9a-f]+,0x[0-9a-f]+,0x[0-9a-f]+,0x[0-9a-f]+,)" "\\1\n        " words "${words}")
+
+    string(APPEND arrays "    alignas(16) inline constexpr uint32_t ${identifier}[] = {\n        ${words}\n    };\n\n")
+    string(APPEND entries "        {\"${file_name}\", ${identifier}, sizeof(${identifier})},\n")
+endforeach()
+
+set(header "// generated by cmake/embed_spirv.cmake -- do not edit\n\n")
+string(APPEND header "#ifndef VULKAN_ENGINE_EMBEDDED_SHADERS_HPP\n#define VULKAN_ENGINE_EMBEDDED_SHADERS_HPP\n\n")
+string(APPEND header "#include <cstdint>\n#include <cstddef>\n#include <string_view>\n\n")
+string(APPEND header "namespace EmbeddedShaders {\n")
+string(APPEND header "${arrays}")
+string(APPEND header "    struct Entry {\n        std::string_view file_name;\n        const uint32_t* code;\n        size_t size;    //in bytes\n    };\n\n")
+string(APPEND header "    inline constexpr Entry entries[] = {\n${entries}    };\n")
+string(APPEND header "}\n\n#endif //VULKAN_ENGINE_EMBEDDED_SHADERS_HPP\n")
+
+# only touching the header if it changed so everything that includes it isn't rebuilt for nothing
+file(WRITE ${OUTPUT}.tmp "${header}")
+configure_file(${OUTPUT}.tmp ${OUTPUT} COPYONLY)
+file(REMOVE ${OUTPUT}.tmp)
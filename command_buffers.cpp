@@ -3,12 +3,17 @@
 //
 
 #include "command_buffers.hpp"
+#include "graphics_pipeline/viewport.hpp"
+#include "graphics_pipeline/scissor.hpp"
 
 #include <stdexcept>
 #include <iostream>
+#include <array>
+#include <optional>
 
-void CommandBuffers::setup() {
-    commandBuffers.resize(frame_buffers.swapChainFramebuffers.size());  //command buffer for every frame buffer
+void CommandBuffers::setup(const unsigned no_buffers) {
+    commandBuffers.resize(no_buffers);  //command buffer for every frame in flight
+    counters.assign(no_buffers, {});
     //allocating the command buffers
     //===============================
     VkCommandBufferAllocateInfo allocInfo{};    //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBufferAllocateInfo.html
@@ -18,89 +23,147 @@ void CommandBuffers::setup() {
                                                                             // - VK_COMMAND_BUFFER_LEVEL_PRIMARY: Can be submitted to a queue for execution, but cannot be called from other command buffers
                                                                             // - VK_COMMAND_BUFFER_LEVEL_SECONDARY: Cannot be submitted directly, but can be called from primary command buffers.
                                                                             //secondary command buffers are useful for reusing common operations
-    allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());        //the number of command buffers to allocate (1 for every framebuffer)
+    allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());        //the number of command buffers to allocate (1 for every frame in flight)
 
     if (vkAllocateCommandBuffers(device.get_device(), &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
         throw std::runtime_error("failed to allocate command buffers!");
     }
 
 
+}
+
+void CommandBuffers::cleanup() {
+    vkFreeCommandBuffers(device.get_device(), command_pool.get_command_pool(), static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+}
+
+void CommandBuffers::record(const unsigned buffer_index, const unsigned image_index, const std::vector<uint32_t>& visible_objects, VkBuffer readback_buffer) {
     //recording the command buffers
     // -  all commands that are to be recorded have the vkCmd prefix
     //===============================
-    for (size_t i = 0; i < commandBuffers.size(); i++) {
-        VkCommandBufferBeginInfo beginInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBufferBeginInfo.html
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;      //sType must be VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
-        beginInfo.flags = 0;                                                //specifies the buffers usage - https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBufferUsageFlagBits.html
-                                                                            // - VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT: The command buffer will be rerecorded right after executing it once.
-                                                                            // - VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT: This is a secondary command buffer that will be entirely within a single render pass.
-                                                                            // - VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT: The command buffer can be resubmitted while it is also already pending execution.
-                                                                            //none of these are applicable RN
-        beginInfo.pInheritanceInfo = nullptr;                               //only relevant to secondary command buffers
-                                                                            // - It specifies which state to inherit from the calling primary command buffers.
-                                                                            //https://khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBufferInheritanceInfo.html
-
-        //start recording the command buffers
-        // - If the command buffer was already recorded once, then a call to vkBeginCommandBuffer will implicitly reset it.
-        // - It's not possible to append commands to a buffer at a later time.
-        // - commands can either be inline or secondary: https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkSubpassContents.html
-        //    > VK_SUBPASS_CONTENTS_INLINE: The render pass commands will be embedded in the primary command buffer itself and no secondary command buffers will be executed
-        //    > VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: The render pass commands will be executed from secondary command buffers.
-        if (vkBeginCommandBuffer(commandBuffers[i], &beginInfo) != VK_SUCCESS) {
-            throw std::runtime_error("failed to begin recording command buffer!");
-        }
-
-        //Drawing starts by beginning the render pass with vkCmdBeginRenderPass
-        //configuring this
-        VkRenderPassBeginInfo renderPassInfo{};     //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkRenderPassBeginInfo.html
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;    //sType must be VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO
-        renderPassInfo.renderPass = render_pass.get_render_pass();          //the render pass to use
-        renderPassInfo.framebuffer = frame_buffers.swapChainFramebuffers[i];    //the framebuffer containing the attachments that are used with the render pass
-                                                                                //currently being used as a colour attachment
-        //defining the render area
-        // - it should match the size of the framebuffer for best performance
-        renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = swap_chain.extent;
-        //how the screen is cleared
-        // - need to clear both the colour and depth attachments
-        std::array<VkClearValue, 2> clearValues{};
-        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clearValues[1].depthStencil = {1.0f, 0};
-
-        renderPassInfo.clearValueCount = clearValues.size();             //the number of clear colours
-        renderPassInfo.pClearValues = clearValues.data();    //array that holds the clear value for each framebuffer
-                                                        //array is indexed by attachment number
-
-        //adding the render pass to the command buffer
-        //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkCmdBeginRenderPass.html
-        vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-        //bind the graphics pipeline
-        // - VK_PIPELINE_BIND_POINT_GRAPHICS because for graphics and not for compute
-        vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline1.get_pipeline());
-
-        //drawing the triangle
-        //========================================================
-        //binding the buffer for drawing
-        // - binding it to binding 0 (the only binding)
-        VkBuffer vertexBuffers1[] = {vertex_buffer1.vertexBuffer};
-        VkDeviceSize offsets1[] = {0};
-        vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, vertexBuffers1, offsets1);
-        //The first two parameters, besides the command buffer, specify the offset and number of bindings we're going to specify vertex buffers for.
-        //The last two parameters specify the array of vertex buffers to bind and the byte offsets to start reading vertex data from
-
-        //telling vulkan to draw the triangle
-        vkCmdDraw(commandBuffers[i], vertex_buffer1.vertices.size(), 1, 0, 0);
-        // - The first parameter is just binding to the command buffer
-        // - The second parameter is the number of vertices (just 3 because using a triangle)
-        // - The third parameter is the offset into the vertex buffer
-        // - The final parameter is and offset used for instanced rendering
-
-        //drawing the square
-        //==========================================================
+    //the command buffer being recorded
+    // - i is the frame in flight, but the framebuffer and descriptor sets are per swapchain image
+    const auto i = buffer_index;
+
+    //counting what is recorded
+    auto& count = counters[i];
+    count = {};
+
+    //finding which objects survived culling
+    std::array<bool, CulledObjects::no_objects> draw_object{};
+    for (const auto object : visible_objects) {
+        draw_object[object] = true;
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBufferBeginInfo.html
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;      //sType must be VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;      //specifies the buffers usage - https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBufferUsageFlagBits.html
+                                                                        // - VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT: The command buffer will be rerecorded right after executing it once.
+                                                                        // - VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT: This is a secondary command buffer that will be entirely within a single render pass.
+                                                                        // - VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT: The command buffer can be resubmitted while it is also already pending execution.
+                                                                        //the buffer is re-recorded every frame so it is only submitted once
+    beginInfo.pInheritanceInfo = nullptr;                               //only relevant to secondary command buffers
+                                                                        // - It specifies which state to inherit from the calling primary command buffers.
+                                                                        //https://khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBufferInheritanceInfo.html
+
+    //start recording the command buffers
+    // - If the command buffer was already recorded once, then a call to vkBeginCommandBuffer will implicitly reset it.
+    // - It's not possible to append commands to a buffer at a later time.
+    // - commands can either be inline or secondary: https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkSubpassContents.html
+    //    > VK_SUBPASS_CONTENTS_INLINE: The render pass commands will be embedded in the primary command buffer itself and no secondary command buffers will be executed
+    //    > VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: The render pass commands will be executed from secondary command buffers.
+    if (vkBeginCommandBuffer(commandBuffers[i], &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("failed to begin recording command buffer!");
+    }
+
+    //timing the frame on the GPU (only if profiling)
+    profiler.begin_frame(commandBuffers[i], i);
+    statistics.begin_frame(commandBuffers[i], i);
+    const auto frame_scope = profiler.begin_scope(commandBuffers[i], "frame");
+
+    //Drawing starts by beginning the render pass with vkCmdBeginRenderPass
+    //configuring this
+    VkRenderPassBeginInfo renderPassInfo{};     //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkRenderPassBeginInfo.html
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;    //sType must be VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO
+    renderPassInfo.renderPass = render_pass.get_render_pass();          //the render pass to use
+    renderPassInfo.framebuffer = frame_buffers.swapChainFramebuffers[image_index];    //the framebuffer containing the attachments that are used with the render pass
+                                                                            //currently being used as a colour attachment
+    //defining the render area
+    // - it should match the size of the framebuffer for best performance
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = swap_chain.extent;
+    //how the screen is cleared
+    // - need to clear both the colour and depth attachments
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    renderPassInfo.clearValueCount = clearValues.size();             //the number of clear colours
+    renderPassInfo.pClearValues = clearValues.data();    //array that holds the clear value for each framebuffer
+                                                    //array is indexed by attachment number
+
+    //adding the render pass to the command buffer
+    //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkCmdBeginRenderPass.html
+    const auto render_pass_scope = profiler.begin_scope(commandBuffers[i], "render pass");
+    vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    //setting the dynamic state of the pipelines
+    // - the pipelines don't store the size of the swapchain so it is set here instead
+    // - it stays set for every pipeline bound afterwards in this command buffer
+    Viewport viewport(static_cast<float>(swap_chain.extent.width), static_cast<float>(swap_chain.extent.height));    //where in the frame buffer to render to
+    Scissor scissor(swap_chain.extent);                                                                                 //the region rendered to to actually display
+    vkCmdSetViewport(commandBuffers[i], 0, 1, &viewport.get_pipeline_stage());
+    vkCmdSetScissor(commandBuffers[i], 0, 1, &scissor.get_pipeline_stage());
+
+    //bind the graphics pipeline
+    // - also sets the cull mode, depth test, etc if they are dynamic (see GraphicsPipeline::bind)
+    //   > bound_state is what has been set so far, so the later pipelines only set the states they change
+    std::optional<PipelineState> bound_state;
+    graphics_pipeline1.bind(commandBuffers[i], bound_state);
+    count.pipeline_binds++;
+
+    //drawing the triangle
+    //========================================================
+    const auto triangle_scope = profiler.begin_scope(commandBuffers[i], "triangle");
+    const auto triangle_pass = statistics.begin_pass(commandBuffers[i], "triangle");
+    //binding the buffer for drawing
+    // - binding it to binding 0 (the only binding)
+    VkBuffer vertexBuffers1[] = {vertex_buffer1.vertexBuffer};
+    VkDeviceSize offsets1[] = {0};
+    vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, vertexBuffers1, offsets1);
+    //The first two parameters, besides the command buffer, specify the offset and number of bindings we're going to specify vertex buffers for.
+    //The last two parameters specify the array of vertex buffers to bind and the byte offsets to start reading vertex data from
+
+    //binding the camera
+    // - every pipeline has the same layout for this set, so it stays bound for the rest of the command buffer
+    vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline1.pipeline_layout, UBO::camera_set, 1, &camera_set.get_sets()[image_index], 0, nullptr);
+    count.descriptor_binds++;
+
+    //the triangle uses the same shader as the square (without the MVP transform), which still references the uniform buffers
+    // - so the object's descriptor set must still be bound (the square's is used, its contents are ignored)
+    vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline1.pipeline_layout, UBO::object_set, 1, &descriptor_set.get_sets()[image_index], 0, nullptr);
+    count.descriptor_binds++;
+
+    //telling vulkan to draw the triangle
+    vkCmdDraw(commandBuffers[i], vertex_buffer1.vertices.size(), 1, 0, 0);
+    // - The first parameter is just binding to the command buffer
+    // - The second parameter is the number of vertices (just 3 because using a triangle)
+    // - The third parameter is the offset into the vertex buffer
+    // - The final parameter is and offset used for instanced rendering
+    count.draw_calls++;
+    count.triangles += vertex_buffer1.vertices.size() / 3;
+    statistics.end_pass(commandBuffers[i], triangle_pass);
+    profiler.end_scope(commandBuffers[i], triangle_scope);
+
+    //drawing the square
+    //==========================================================
+    if (draw_object[CulledObjects::square]) {
+        const auto square_scope = profiler.begin_scope(commandBuffers[i], "square");
+        const auto square_pass = statistics.begin_pass(commandBuffers[i], "square");
+
         //using a different pipeline because using a different shader to draw this
         // - not can just have multiple calls to vkCmdDraw and/or vkCmdDrawIndexed in the same graphics pipeline
-        vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline2.get_pipeline());
+        graphics_pipeline2.bind(commandBuffers[i], bound_state);
+        count.pipeline_binds++;
 
         //note this is no done optimally
         //should have the vertex and index buffers as one big buffer and use offsets
@@ -112,16 +175,27 @@ void CommandBuffers::setup() {
 
         //binding the descriptor set
         // - i.e. updating the layout values in the shader
-        vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline2.pipeline_layout, 0, 1, &descriptor_set.get_sets()[i], 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline2.pipeline_layout, UBO::object_set, 1, &descriptor_set.get_sets()[image_index], 0, nullptr);
+        count.descriptor_binds++;
 
         vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(index_buffer.indices.size()), 1, 0, 0, 0);
+        count.draw_calls++;
+        count.triangles += index_buffer.indices.size() / 3;
+        statistics.end_pass(commandBuffers[i], square_pass);
+        profiler.end_scope(commandBuffers[i], square_scope);
+    }
 
 
-        //drawing the second square
-        //==========================================================
+    //drawing the second square
+    //==========================================================
+    //the pipeline and vertex buffer are shared by both textured squares, so only binding them if either is drawn
+    const auto textured_scope = profiler.begin_scope(commandBuffers[i], "textured squares");
+    const auto textured_pass = statistics.begin_pass(commandBuffers[i], "textured squares");
+    if (draw_object[CulledObjects::textured_square1] || draw_object[CulledObjects::textured_square2]) {
         //using a different pipeline because using a different shader to draw this
         // - not can just have multiple calls to vkCmdDraw and/or vkCmdDrawIndexed in the same graphics pipeline
-        vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline3.get_pipeline());
+        graphics_pipeline3.bind(commandBuffers[i], bound_state);
+        count.pipeline_binds++;
 
         //note this is no done optimally
         //should have the vertex and index buffers as one big buffer and use offsets
@@ -130,26 +204,71 @@ void CommandBuffers::setup() {
         vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, vertexBuffers3, offsets3);
 
         vkCmdBindIndexBuffer(commandBuffers[i], index_buffer.indexBuffer, 0, VK_INDEX_TYPE_UINT16);  //index buffer uses 16bit integers
+    }
 
+    if (draw_object[CulledObjects::textured_square1]) {
         //binding the descriptor set
         // - i.e. updating the layout values in the shader
-        vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline3.pipeline_layout, 0, 1, &descriptor_set2.get_sets()[i], 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline3.pipeline_layout, UBO::object_set, 1, &descriptor_set2.get_sets()[image_index], 0, nullptr);
+        count.descriptor_binds++;
 
         vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(index_buffer.indices.size()), 1, 0, 0, 0);
+        count.draw_calls++;
+        count.triangles += index_buffer.indices.size() / 3;
+    }
 
+    if (draw_object[CulledObjects::textured_square2]) {
         //binding the descriptor set for the other textured square
         // - i.e. updating the layout values in the shader
-        vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline3.pipeline_layout, 0, 1, &descriptor_set3.get_sets()[i], 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline3.pipeline_layout, UBO::object_set, 1, &descriptor_set3.get_sets()[image_index], 0, nullptr);
+        count.descriptor_binds++;
 
         vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(index_buffer.indices.size()), 1, 0, 0, 0);
+        count.draw_calls++;
+        count.triangles += index_buffer.indices.size() / 3;
+    }
+
+    statistics.end_pass(commandBuffers[i], textured_pass);
+    profiler.end_scope(commandBuffers[i], textured_scope);
 
-        //no longer recording to the render pass
-        vkCmdEndRenderPass(commandBuffers[i]);
+    //no longer recording to the render pass
+    vkCmdEndRenderPass(commandBuffers[i]);
+    profiler.end_scope(commandBuffers[i], render_pass_scope);
 
-        //no longer recording the command buffer
-        if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS) {
-            throw std::runtime_error("failed to record command buffer!");
-        }
+    //copying the image out so it can be read on the CPU
+    // - the render pass leaves the image in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL and its dependency makes the copy wait for the rendering
+    if (readback_buffer != VK_NULL_HANDLE) {
+        const auto readback_scope = profiler.begin_scope(commandBuffers[i], "readback");
+        VkBufferImageCopy region{};     //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkBufferImageCopy.html
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;     //0 means the rows are tightly packed
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {swap_chain.extent.width, swap_chain.extent.height, 1};
+        vkCmdCopyImageToBuffer(commandBuffers[i], swap_chain.swapChainImages[image_index], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback_buffer, 1, &region);
+
+        //making the copy visible to the CPU once the frame is finished
+        VkBufferMemoryBarrier barrier{};    //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkBufferMemoryBarrier.html
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = readback_buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        vkCmdPipelineBarrier(commandBuffers[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        profiler.end_scope(commandBuffers[i], readback_scope);
     }
 
+    profiler.end_scope(commandBuffers[i], frame_scope);
+
+    //no longer recording the command buffer
+    if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS) {
+        throw std::runtime_error("failed to record command buffer!");
+    }
 }
@@ -15,23 +15,47 @@
 #include "vertex_buffer.hpp"
 #include "index_buffer.hpp"
 #include "descriptor_set.hpp"
+#include "gpu_profiler.hpp"
+#include "pipeline_statistics.hpp"
+#include "frame_stats.hpp"
+
+#include <cstdint>
+
+//the objects that go through frustum culling
+// - these are the indices used for the bounds in the renderer, and the indices in the visible list passed to record
+namespace CulledObjects {
+    enum : uint32_t {square = 0, textured_square1, textured_square2, no_objects};
+}
 
 //all commands in vulkan must be submitted using a command buffer
 // - command buffers are allocated from command pools
 struct CommandBuffers {
     CommandBuffers(LogicalDevice &d, CommandPool &c, Framebuffers &f, RenderPass &r, SwapChain &s, GraphicsPipeline<Vertex::TWOD_VC> &g1, GraphicsPipeline<Vertex::TWOD_VC> &g2, GraphicsPipeline<Vertex::TWOD_VT> &g3, VertexBuffer<Vertex::TWOD_VC> &v1,
-                   VertexBuffer<Vertex::TWOD_VC> &v2, IndexBuffer<uint16_t> &i, DescriptorSet &set,
-                   VertexBuffer<Vertex::TWOD_VT> &v3, DescriptorSet &set2, DescriptorSet &set3)
+                   VertexBuffer<Vertex::TWOD_VC> &v2, IndexBuffer<uint16_t> &i, DescriptorSet &camera, DescriptorSet &set,
+                   VertexBuffer<Vertex::TWOD_VT> &v3, DescriptorSet &set2, DescriptorSet &set3, GpuProfiler &p, PipelineStatistics &ps)
         : device(d), command_pool(c), frame_buffers(f), render_pass(r), swap_chain(s), graphics_pipeline1(g1), graphics_pipeline2(g2), graphics_pipeline3(g3), vertex_buffer1(v1), vertex_buffer2(v2),
-          index_buffer(i), descriptor_set(set), vertex_buffer3(v3), descriptor_set2(set2), descriptor_set3(set3){}
+          index_buffer(i), camera_set(camera), descriptor_set(set), vertex_buffer3(v3), descriptor_set2(set2), descriptor_set3(set3), profiler(p), statistics(ps){}
 
     //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkCommandBuffer.html
-    std::vector<VkCommandBuffer> commandBuffers;    //need a command buffer for every framebuffer
+    std::vector<VkCommandBuffer> commandBuffers;    //need a command buffer for every frame that can be in flight
+                                                    // - these are re-recorded every frame, so only need as many as can be executing at once
+
+    //allocating the command buffers
+    void setup(unsigned no_buffers);
+    void cleanup();
 
-    void setup();
+    //recording the drawing commands for a frame
+    // - buffer_index is the command buffer to record to (the current frame in flight)
+    // - image_index is the swapchain image being rendered to
+    // - visible_objects are the CulledObjects that passed frustum culling (in any order)
+    // - if readback_buffer is given the rendered image is copied into it (headless only, see FrameReadback)
+    void record(unsigned buffer_index, unsigned image_index, const std::vector<uint32_t>& visible_objects, VkBuffer readback_buffer = VK_NULL_HANDLE);
 
     [[nodiscard]] std::vector<VkCommandBuffer>& get_command_buffers() {return commandBuffers;}
 
+    //what was recorded into a command buffer the last time it was recorded
+    [[nodiscard]] const DrawCounters& get_counters(const unsigned buffer_index) const {return counters[buffer_index];}
+
     //the colour the screen gets cleared to
     static constexpr VkClearValue clear_colour = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
 
@@ -48,9 +72,14 @@ private:
     VertexBuffer<Vertex::TWOD_VC>& vertex_buffer2;
     VertexBuffer<Vertex::TWOD_VT>& vertex_buffer3;
     IndexBuffer<uint16_t>& index_buffer;
+    DescriptorSet &camera_set;      //bound once at UBO::camera_set, the others are per object at UBO::object_set
     DescriptorSet &descriptor_set;
     DescriptorSet &descriptor_set2;
     DescriptorSet &descriptor_set3;
+    GpuProfiler &profiler;
+    PipelineStatistics &statistics;
+
+    std::vector<DrawCounters> counters;     //for every command buffer
 };
 
 
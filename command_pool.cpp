@@ -11,10 +11,10 @@ void CommandPool::setup() {
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;                //sType must be VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO
     poolInfo.queueFamilyIndex = queue_family.graphicsFamily.value();            //the queue that the command buffers submit to
                                                                                 //doing graphics operations so allocating to the graphics queue
-    poolInfo.flags = 0;             //possible flags:
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;             //possible flags:
                                     // - VK_COMMAND_POOL_CREATE_TRANSIENT_BIT: Hint that command buffers are rerecorded with new commands very often (may change memory allocation behavior)
                                     // - VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT: Allow command buffers to be rerecorded individually, without this flag they all have to be reset together
-                                    //we are only recording 1 command buffer at the beginning of the program so none of these are relevant
+                                    //the drawing commands are re-recorded every frame (only the objects that pass culling are drawn) so each buffer needs to be reset on its own
     const auto create_res = vkCreateCommandPool(device.get_device(), &poolInfo, nullptr, &command_pool);
     if (create_res != VK_SUCCESS) {
         throw std::runtime_error("failed to create command pool!");
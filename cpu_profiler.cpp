@@ -0,0 +1,125 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "cpu_profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace {
+    //a ring buffer written by one thread and read by the thread calling drain
+    // - every slot is a seqlock: its sequence is odd while the slot is being written, and 2 * (index + 1) once timing `index' is in it
+    // - the reader checks the sequence before and after reading a slot, and throws the timing away if the slot was being written or now
+    //   holds a different timing (the writer lapped the ring)
+    // - the fields are relaxed atomics so reading a slot while it is being overwritten is not undefined behaviour
+    struct ThreadRing {
+        struct Slot {
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<int64_t> start{0};
+            std::atomic<int64_t> end{0};
+        };
+        std::array<Slot, CpuProfiler::ring_size> slots;
+        std::atomic<uint64_t> written{0};   //the number of timings ever written
+        uint64_t read = 0;                  //the number of timings drain has looked at (only used by drain)
+        uint32_t thread = 0;
+    };
+
+    //every thread that has recorded something
+    // - the rings are kept after their thread ends so drain never reads freed memory
+    struct Registry {
+        std::mutex mutex;   //only taken when a thread records for the first time and in drain
+        std::vector<std::unique_ptr<ThreadRing>> rings;
+    };
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    ThreadRing& thread_ring() {
+        thread_local ThreadRing* ring = [] {
+            auto new_ring = std::make_unique<ThreadRing>();
+            new_ring->thread = Trace::thread_id();
+            auto& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.rings.push_back(std::move(new_ring));
+            return r.rings.back().get();
+        }();
+        return *ring;
+    }
+}
+
+void CpuProfiler::record(const char* name, const int64_t start, const int64_t end) {
+    auto& ring = thread_ring();
+    const auto index = ring.written.load(std::memory_order_relaxed);
+    auto& slot = ring.slots[index % ring_size];
+
+    //marking the slot as being written before touching any of it
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);     //publishing the slot
+
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+void CpuProfiler::drain(std::vector<Record>& records) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& ring : r.rings) {
+        const auto written = ring->written.load(std::memory_order_acquire);
+        //skipping anything that has already been overwritten
+        if (written - ring->read > ring_size) {
+            ring->read = written - ring_size;
+        }
+        for (; ring->read < written; ring->read++) {
+            const auto& slot = ring->slots[ring->read % ring_size];
+            const uint64_t expected = 2 * ring->read + 2;
+            if (slot.sequence.load(std::memory_order_acquire) != expected) {
+                continue;   //already being overwritten
+            }
+            const Record record{slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed), ring->thread};
+            //the thread may have started overwriting the slot while it was being read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+                continue;
+            }
+            records.push_back(record);
+        }
+    }
+}
+
+void ScopeStats::add(const CpuProfiler::Record& record) {
+    auto& durations = scopes[record.name];
+    const auto duration = record.end - record.start;
+    if (durations.samples.size() < window) {
+        durations.samples.push_back(duration);
+    } else {
+        durations.samples[durations.next] = duration;
+        durations.next = (durations.next + 1) % window;
+    }
+}
+
+std::vector<ScopeStats::Summary> ScopeStats::summarise() const {
+    std::vector<Summary> summaries;
+    summaries.reserve(scopes.size());
+    std::vector<int64_t> sorted;
+    for (const auto& [name, durations] : scopes) {
+        if (durations.samples.empty()) {
+            continue;
+        }
+        sorted = durations.samples;
+        std::sort(sorted.begin(), sorted.end());
+        const auto percentile = [&](const size_t p) {return sorted[(sorted.size() - 1) * p / 100];};
+        summaries.push_back({name, sorted.size(), percentile(50), percentile(99), sorted.back()});
+    }
+    //in a consistent order for printing
+    std::sort(summaries.begin(), summaries.end(), [](const Summary& a, const Summary& b) {return a.name < b.name;});
+    return summaries;
+}
@@ -0,0 +1,86 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_CPU_PROFILER_HPP
+#define VULKAN_ENGINE_CPU_PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "trace.hpp"
+
+//timing parts of the program on the CPU
+// - PROFILE_SCOPE("name") times from where it is to the end of the enclosing block
+// - each thread writes its timings into its own ring buffer, so recording never takes a lock or allocates
+// - the timings are taken out of the ring buffers by CpuProfiler::drain (e.g. once a frame) and then go to ScopeStats and/or the trace
+// - cmake -DENGINE_PROFILING=OFF removes the scopes entirely
+#ifdef ENGINE_PROFILING
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) const CpuProfiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace CpuProfiler {
+    struct Record {
+        const char* name;   //must live for the whole program (i.e. a string literal)
+        int64_t start;      //ns, see Trace::now
+        int64_t end;
+        uint32_t thread;    //Trace::thread_id of the thread the scope was on
+    };
+
+    //adding a timing to the calling thread's ring buffer
+    // - if the ring buffer is full the oldest timing is overwritten
+    void record(const char* name, int64_t start, int64_t end);
+
+    //taking every timing recorded since the last call, from every thread
+    // - only one thread may call this at a time
+    void drain(std::vector<Record>& records);
+
+    //the number of timings each thread can hold before drain has to be called
+    constexpr size_t ring_size = 4096;
+
+    class Scope {
+    public:
+        explicit Scope(const char* n) : name(n), start(Trace::now()) {}
+        ~Scope() {record(name, start, Trace::now());}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        int64_t start;
+    };
+}
+
+//the percentiles of how long each scope took over its last `window' runs
+// - not thread safe, meant to be fed by whichever thread calls CpuProfiler::drain
+struct ScopeStats {
+    struct Summary {
+        std::string_view name;
+        size_t samples;     //the number of runs the percentiles are over
+        int64_t p50;        //ns
+        int64_t p99;
+        int64_t max;
+    };
+
+    explicit ScopeStats(const size_t w = 240) : window(w) {}   //~4s at 60fps
+
+    void add(const CpuProfiler::Record& record);
+    [[nodiscard]] std::vector<Summary> summarise() const;
+
+private:
+    struct Durations {
+        std::vector<int64_t> samples;   //a ring buffer of the last `window' durations
+        size_t next = 0;
+    };
+    size_t window;
+    std::unordered_map<std::string_view, Durations> scopes;     //by name (the same name in different files may be different pointers)
+};
+
+
+#endif //VULKAN_ENGINE_CPU_PROFILER_HPP
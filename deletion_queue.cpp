@@ -0,0 +1,32 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "deletion_queue.hpp"
+#include <stdexcept>
+#include <utility>
+
+void DeletionQueue::push(const uint64_t frame, std::function<void()> destroy) {
+    if (!entries.empty() && frame < entries.back().frame) {
+        throw std::runtime_error("deletions must be pushed in frame order");
+    }
+    entries.push_back({frame, std::move(destroy)});
+}
+
+void DeletionQueue::collect(const uint64_t completed_frame) {
+    //the entries are sorted so can stop at the first that is still in use
+    while (!entries.empty() && entries.front().frame <= completed_frame) {
+        //removing the entry before running it so a throwing destroy doesn't get run twice
+        auto destroy = std::move(entries.front().destroy);
+        entries.pop_front();
+        destroy();
+    }
+}
+
+void DeletionQueue::flush() {
+    while (!entries.empty()) {
+        auto destroy = std::move(entries.front().destroy);
+        entries.pop_front();
+        destroy();
+    }
+}
@@ -0,0 +1,40 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_DELETION_QUEUE_HPP
+#define VULKAN_ENGINE_DELETION_QUEUE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+//destroying vulkan objects once the GPU is no longer using them
+// - objects used by a frame can't be destroyed until the GPU has finished that frame
+// - rather than waiting for the whole device to be idle, the destruction is pushed here tagged with the last frame that could use the object
+//   and run once the GPU has finished that frame (see collect)
+// - frames are numbered by the order they are submitted in, starting at 1 (0 means no frame, so is always finished)
+struct DeletionQueue {
+    //destroying something once `frame' has finished on the GPU
+    // - frames must be pushed in order (i.e. never less than a frame pushed before)
+    void push(uint64_t frame, std::function<void()> destroy);
+
+    //destroying everything that was used by frames up to and including `completed_frame'
+    void collect(uint64_t completed_frame);
+
+    //destroying everything
+    // - only safe when the device is idle
+    void flush();
+
+    [[nodiscard]] size_t size() const {return entries.size();}
+
+private:
+    struct Entry {
+        uint64_t frame;
+        std::function<void()> destroy;
+    };
+    std::deque<Entry> entries;  //sorted by frame (because they are pushed in order)
+};
+
+
+#endif //VULKAN_ENGINE_DELETION_QUEUE_HPP
@@ -8,6 +8,7 @@
 #include "logical_device.hpp"
 #include "texture.hpp"
 #include "swap_chain.hpp"
+#include "deletion_queue.hpp"
 
 struct DepthImage {
     VkImage depthImage{};
@@ -22,6 +23,18 @@ struct DepthImage {
         vkDestroyImage(device.get_device(), depthImage, nullptr);
         vkFreeMemory(device.get_device(), depthImageMemory, nullptr);
     }
+    //destroying the depth image once `frame' has finished on the GPU
+    // - setup can be called straight away to make a new depth image
+    void retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+        deletion_queue.push(frame, [d = device.get_device(), view = depthImageView, image = depthImage, memory = depthImageMemory] {
+            vkDestroyImageView(d, view, nullptr);
+            vkDestroyImage(d, image, nullptr);
+            vkFreeMemory(d, memory, nullptr);
+        });
+        depthImageView = VK_NULL_HANDLE;
+        depthImage = VK_NULL_HANDLE;
+        depthImageMemory = VK_NULL_HANDLE;
+    }
 
 private:
     LogicalDevice &device;
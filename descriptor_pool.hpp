@@ -8,6 +8,7 @@
 #include <vulkan/vulkan.h>
 #include "logical_device.hpp"
 #include "swap_chain.hpp"
+#include "deletion_queue.hpp"
 #include <stdexcept>
 
 //holds the memory for the descriptor sets
@@ -20,6 +21,13 @@ struct DescriptorPool {
 
     virtual void setup() {}
     void cleanup() {vkDestroyDescriptorPool(device.get_device(), descriptorPool, nullptr);}
+    //destroying the pool (and so every set allocated from it) once `frame' has finished on the GPU
+    void retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+        deletion_queue.push(frame, [d = device.get_device(), old_pool = descriptorPool] {
+            vkDestroyDescriptorPool(d, old_pool, nullptr);
+        });
+        descriptorPool = VK_NULL_HANDLE;
+    }
 
 protected:
     LogicalDevice& device;
@@ -30,7 +30,7 @@ void DescriptorSet1::setup() {
         bufferInfo.buffer = UBO.get_buffers()[i];   //the buffer to attach to this descriptor set
         bufferInfo.offset = 0;                      //the offset in bytes into the buffer
                                                     // - not doing anything fancy so this is just 0
-        bufferInfo.range = sizeof(UBO::mvp);        //the size in bytes used for a descriptor updated
+        bufferInfo.range = UBO.get_size();          //the size in bytes used for a descriptor updated
                                                     // - this is the size of the object in question
 
         VkWriteDescriptorSet descriptorWrite{};                             //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkWriteDescriptorSet.html
@@ -82,7 +82,7 @@ void DescriptorSet2::setup() {
         bufferInfo.buffer = UBO.get_buffers()[i];   //the buffer to attach to this descriptor set
         bufferInfo.offset = 0;                      //the offset in bytes into the buffer
                                                     // - not doing anything fancy so this is just 0
-        bufferInfo.range = sizeof(UBO::mvp);        //the size in bytes used for a descriptor updated
+        bufferInfo.range = UBO.get_size();          //the size in bytes used for a descriptor updated
                                                     // - this is the size of the object in question
 
         //info for the texture sampler
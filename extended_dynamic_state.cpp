@@ -0,0 +1,71 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "extended_dynamic_state.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+ExtendedDynamicState::Support ExtendedDynamicState::query_support(VkPhysicalDevice physical_device) {
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(physical_device, &device_properties);
+    if (device_properties.apiVersion >= VK_API_VERSION_1_3) {
+        return Support::core;   //the functionality is required in 1.3, no feature needs to be checked
+    }
+    //vkGetPhysicalDeviceFeatures2 is only core from 1.1
+    if (device_properties.apiVersion < VK_API_VERSION_1_1) {
+        return Support::none;
+    }
+
+    //checking the extension is available
+    uint32_t extension_count;
+    vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+    std::vector<VkExtensionProperties> available_extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions.data());
+    bool has_extension = false;
+    for (const auto& extension : available_extensions) {
+        if (std::strcmp(extension.extensionName, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME) == 0) {
+            has_extension = true;
+            break;
+        }
+    }
+    if (!has_extension) {
+        return Support::none;
+    }
+
+    //the extension can be there without the feature being supported
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extended_dynamic_state_features{};     //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkPhysicalDeviceExtendedDynamicStateFeaturesEXT.html
+    extended_dynamic_state_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &extended_dynamic_state_features;
+    vkGetPhysicalDeviceFeatures2(physical_device, &features);
+
+    return extended_dynamic_state_features.extendedDynamicState ? Support::extension : Support::none;
+}
+
+void ExtendedDynamicState::load(VkDevice device, const Support support) {
+    is_enabled = false;
+    if (support == Support::none) {
+        return;
+    }
+
+    //the extension functions have an EXT suffix
+    const bool core = support == Support::core;
+    const auto get = [&](const char* core_name, const char* extension_name) {
+        const auto function = vkGetDeviceProcAddr(device, core ? core_name : extension_name);
+        if (function == nullptr) {
+            throw std::runtime_error("failed to load extended dynamic state functions");
+        }
+        return function;
+    };
+
+    set_cull_mode = reinterpret_cast<PFN_vkCmdSetCullMode>(get("vkCmdSetCullMode", "vkCmdSetCullModeEXT"));
+    set_front_face = reinterpret_cast<PFN_vkCmdSetFrontFace>(get("vkCmdSetFrontFace", "vkCmdSetFrontFaceEXT"));
+    set_primitive_topology = reinterpret_cast<PFN_vkCmdSetPrimitiveTopology>(get("vkCmdSetPrimitiveTopology", "vkCmdSetPrimitiveTopologyEXT"));
+    set_depth_test_enable = reinterpret_cast<PFN_vkCmdSetDepthTestEnable>(get("vkCmdSetDepthTestEnable", "vkCmdSetDepthTestEnableEXT"));
+    set_depth_write_enable = reinterpret_cast<PFN_vkCmdSetDepthWriteEnable>(get("vkCmdSetDepthWriteEnable", "vkCmdSetDepthWriteEnableEXT"));
+    set_depth_compare_op = reinterpret_cast<PFN_vkCmdSetDepthCompareOp>(get("vkCmdSetDepthCompareOp", "vkCmdSetDepthCompareOpEXT"));
+    is_enabled = true;
+}
@@ -0,0 +1,44 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_EXTENDED_DYNAMIC_STATE_HPP
+#define VULKAN_ENGINE_EXTENDED_DYNAMIC_STATE_HPP
+
+#include <vulkan/vulkan.h>
+
+//setting the cull mode, front face, topology and depth test when recording the command buffer rather than when creating the pipeline
+// - means pipelines that only differ by these states can be the same pipeline (less pipelines to compile and switch between)
+// - part of core vulkan 1.3, otherwise needs the VK_EXT_extended_dynamic_state extension
+//   > https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VK_EXT_extended_dynamic_state.html
+// - if neither is supported, the states are baked into the pipelines like before
+struct ExtendedDynamicState {
+    enum class Support {
+        none,       //the states must be baked into the pipeline
+        extension,  //VK_EXT_extended_dynamic_state must be enabled on the device
+        core        //vulkan 1.3, nothing needs to be enabled
+    };
+
+    //how the physical device supports extended dynamic state
+    static Support query_support(VkPhysicalDevice physical_device);
+
+    //getting the functions to set the states
+    // - must be called after the logical device is created (with the extension enabled if support is Support::extension)
+    void load(VkDevice device, Support support);
+
+    [[nodiscard]] bool enabled() const {return is_enabled;}
+
+    //the functions have the same signature for the extension and core versions
+    PFN_vkCmdSetCullMode set_cull_mode = nullptr;
+    PFN_vkCmdSetFrontFace set_front_face = nullptr;
+    PFN_vkCmdSetPrimitiveTopology set_primitive_topology = nullptr;
+    PFN_vkCmdSetDepthTestEnable set_depth_test_enable = nullptr;
+    PFN_vkCmdSetDepthWriteEnable set_depth_write_enable = nullptr;
+    PFN_vkCmdSetDepthCompareOp set_depth_compare_op = nullptr;
+
+private:
+    bool is_enabled = false;
+};
+
+
+#endif //VULKAN_ENGINE_EXTENDED_DYNAMIC_STATE_HPP
@@ -6,20 +6,23 @@
 #define VULKAN_ENGINE_FENCES_HPP
 
 #include <vulkan/vulkan.h>
-#include <array>
+#include <vector>
+#include <stdexcept>
 #include "logical_device.hpp"
 
 //fences perform CPU-GPU synchronisation
 // - actually wait for them explictly in the code
-template <unsigned no_fences>
+// - one for every frame in flight (which can change while running, see PresentSettings)
 struct Fences{
     explicit Fences(LogicalDevice &d) : device(d) {}
 
-    std::array<VkFence, no_fences> in_flight_fences;
+    std::vector<VkFence> in_flight_fences;
 
-    [[nodiscard]] std::array<VkFence, no_fences>& get_fences() {return in_flight_fences;}
+    [[nodiscard]] std::vector<VkFence>& get_fences() {return in_flight_fences;}
+
+    void setup(const unsigned no_fences) {
+        in_flight_fences.resize(no_fences);
 
-    void setup() {
         //creating fences is trivial
         VkFenceCreateInfo fenceInfo{};      //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkFenceCreateInfo.html
         fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;  //sType must be VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
@@ -39,6 +42,7 @@ struct Fences{
         for (auto& fence : in_flight_fences) {
             vkDestroyFence(device.get_device(), fence, nullptr);
         }
+        in_flight_fences.clear();
     }
 
 private:
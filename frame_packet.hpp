@@ -0,0 +1,33 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_FRAME_PACKET_HPP
+#define VULKAN_ENGINE_FRAME_PACKET_HPP
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "command_buffers.hpp"
+#include "uniform_buffer_objects.hpp"
+
+//everything that changes from frame to frame that the render thread needs to draw a frame
+// - made by Renderer::simulate (on the main thread) and then never changed, so it can be handed to the render thread without locking
+// - while the render thread records and submits one packet the main thread is already making the next one
+struct FramePacket {
+    uint64_t number = 0;    //the order the packets were made in (starting at 1)
+
+    //the camera
+    // - the projection is for the size the window was when the packet was made
+    UBO::camera camera{glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f)};
+
+    //where every object is -- indexed by CulledObjects
+    std::array<glm::mat4, CulledObjects::no_objects> models{};
+
+    //the objects that passed frustum culling (in the order SceneBVH::query found them, not sorted)
+    std::vector<uint32_t> visible_objects;
+};
+
+#endif //VULKAN_ENGINE_FRAME_PACKET_HPP
@@ -0,0 +1,45 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "frame_readback.hpp"
+#include "buffer.hpp"
+#include <utility>
+
+void FrameReadback::setup(const unsigned no_frames) {
+    extent = swap_chain.extent;
+
+    buffers.resize(no_frames);
+    buffersMemory.resize(no_frames);
+    mapped.resize(no_frames);
+    for (unsigned i = 0; i < no_frames; i++) {
+        //the GPU writes to these and the CPU reads from them, so they have to be visible to the host
+        // - coherent so the memory doesn't need to be invalidated before reading
+        create_buffer(device, frame_size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffers[i], buffersMemory[i]);
+        vkMapMemory(device.get_device(), buffersMemory[i], 0, frame_size(), 0, &mapped[i]);
+    }
+}
+
+void FrameReadback::cleanup() {
+    for (size_t i = 0; i < buffers.size(); i++) {
+        vkUnmapMemory(device.get_device(), buffersMemory[i]);
+        vkDestroyBuffer(device.get_device(), buffers[i], nullptr);
+        vkFreeMemory(device.get_device(), buffersMemory[i], nullptr);
+    }
+    buffers.clear();
+    buffersMemory.clear();
+    mapped.clear();
+}
+
+void FrameReadback::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    //freeing the memory also unmaps it
+    deletion_queue.push(frame, [d = device.get_device(), old_buffers = std::move(buffers), memory = std::move(buffersMemory)] {
+        for (size_t i = 0; i < old_buffers.size(); i++) {
+            vkDestroyBuffer(d, old_buffers[i], nullptr);
+            vkFreeMemory(d, memory[i], nullptr);
+        }
+    });
+    buffers.clear();
+    buffersMemory.clear();
+    mapped.clear();
+}
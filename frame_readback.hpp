@@ -0,0 +1,44 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_FRAME_READBACK_HPP
+#define VULKAN_ENGINE_FRAME_READBACK_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "logical_device.hpp"
+#include "swap_chain.hpp"
+#include "deletion_queue.hpp"
+
+//buffers the rendered images are copied into so they can be read on the CPU (only used when headless)
+// - a buffer for every frame in flight, the copy is recorded at the end of the frame's command buffer (see CommandBuffers::record)
+// - a buffer is only written again once its frame in flight is reused, which waits for the frame that last used it
+// - the buffers stay mapped for as long as they exist
+struct FrameReadback {
+    std::vector<VkBuffer> buffers;
+    std::vector<VkDeviceMemory> buffersMemory;
+    std::vector<void*> mapped;
+
+    FrameReadback(LogicalDevice &d, SwapChain &s) : device(d), swap_chain(s) {}
+
+    //buffers large enough for the current swap chain images
+    void setup(unsigned no_frames);
+    void cleanup();
+    //destroying the buffers once `frame' has finished on the GPU
+    // - setup can be called straight away to make new buffers (e.g. when the number of frames in flight changes)
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
+
+    //the pixels are tightly packed rows of 4 byte pixels (the format of the swap chain images)
+    [[nodiscard]] VkDeviceSize frame_size() const {return static_cast<VkDeviceSize>(extent.width) * extent.height * 4;}
+    [[nodiscard]] const VkExtent2D& get_extent() const {return extent;}
+
+private:
+    VkExtent2D extent{};    //the size of the images the buffers were made for
+
+    LogicalDevice &device;
+    SwapChain &swap_chain;
+};
+
+
+#endif //VULKAN_ENGINE_FRAME_READBACK_HPP
@@ -0,0 +1,37 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_FRAME_STATS_HPP
+#define VULKAN_ENGINE_FRAME_STATS_HPP
+
+#include <cstdint>
+#include <vector>
+
+//what the engine asked the GPU to do while recording a frame
+// - counted by CommandBuffers::record, so redundant state changes show up as numbers rather than by eye
+struct DrawCounters {
+    uint32_t draw_calls = 0;
+    uint32_t pipeline_binds = 0;
+    uint32_t descriptor_binds = 0;
+    uint64_t triangles = 0;     //submitted, i.e. before culling and clipping
+};
+
+//what the GPU actually did for one pass of a frame (see PipelineStatistics)
+// - https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkQueryPipelineStatisticFlagBits.html
+struct PassStatistics {
+    const char* name;
+    uint64_t vertex_invocations;    //how many times the vertex shader ran
+    uint64_t clipping_invocations;  //primitives that reached the clipping stage
+    uint64_t clipping_primitives;   //primitives that came out of clipping (i.e. were not culled or clipped away)
+    uint64_t fragment_invocations;  //how many times the fragment shader ran -- compared to the number of pixels, this is the overdraw
+};
+
+//everything known about a frame once it has finished on the GPU
+struct FrameStats {
+    uint64_t frame = 0;     //the frame's number (0 if no frame has finished yet)
+    DrawCounters counters;
+    std::vector<PassStatistics> passes;     //empty unless pipeline statistics are enabled (see Renderer::pipeline_statistics_variable)
+};
+
+#endif //VULKAN_ENGINE_FRAME_STATS_HPP
@@ -4,6 +4,7 @@
 
 #include "framebuffers.hpp"
 #include <stdexcept>
+#include <utility>
 
 void Framebuffers::setup() {
     const auto no_framebuffers = image_views.swapChainImageViews.size();
@@ -39,3 +40,12 @@ void Framebuffers::cleanup() {
     }
 
 }
+
+void Framebuffers::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    deletion_queue.push(frame, [d = device.get_device(), old_framebuffers = std::move(swapChainFramebuffers)] {
+        for (const auto& framebuffer : old_framebuffers) {
+            vkDestroyFramebuffer(d, framebuffer, nullptr);
+        }
+    });
+    swapChainFramebuffers.clear();
+}
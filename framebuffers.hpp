@@ -20,6 +20,9 @@ struct Framebuffers {
 
     void setup();
     void cleanup();
+    //destroying the framebuffers once `frame' has finished on the GPU
+    // - setup can be called straight away to make new framebuffers
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
 
     //the actual frame buffers
     // - https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkFramebuffer.html
@@ -0,0 +1,113 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_FRUSTUM_HPP
+#define VULKAN_ENGINE_FRUSTUM_HPP
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cmath>
+
+//axis aligned bounding box
+// - the bounding volume used for culling and picking
+struct AABB {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+
+    [[nodiscard]] glm::vec3 center() const {return (min + max) * 0.5f;}
+    [[nodiscard]] glm::vec3 extent() const {return (max - min) * 0.5f;}    //half the size of the box along each axis
+
+    //the box that contains both boxes
+    [[nodiscard]] AABB merge(const AABB& other) const {return {glm::min(min, other.min), glm::max(max, other.max)};}
+
+    //the box around this box once it has been transformed (e.g. by a model matrix)
+    // - the center is transformed, and the extent along each new axis is the sum of the old extents scaled by how much they point along it (Arvo)
+    [[nodiscard]] AABB transformed(const glm::mat4& matrix) const {
+        const auto old_center = center();
+        const auto e = extent();
+        glm::vec3 c(matrix[3][0], matrix[3][1], matrix[3][2]);
+        glm::vec3 new_extent(0.0f);
+        for (int col = 0; col < 3; col++) {
+            for (int row = 0; row < 3; row++) {
+                c[row] += matrix[col][row] * old_center[col];
+                new_extent[row] += std::fabs(matrix[col][row]) * e[col];
+            }
+        }
+        return {c - new_extent, c + new_extent};
+    }
+
+    //half the surface area -- used as the cost of a node when building a tree of boxes
+    [[nodiscard]] float half_area() const {
+        const auto d = max - min;
+        return d.x*d.y + d.y*d.z + d.z*d.x;
+    }
+};
+
+//the 6 planes bounding what the camera can see
+// - each plane is stored as (normal, distance) with the normal pointing into the frustum
+// - a point p is in front of (inside) the plane when dot(normal, p) + distance >= 0
+struct Frustum {
+    enum side {left_plane = 0, right_plane, bottom_plane, top_plane, near_plane, far_plane};
+    std::array<glm::vec4, 6> planes{};
+
+    //extracting the planes from a view-projection matrix (Gribb & Hartmann)
+    // - https://www.gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
+    // - the clip volume is -w<=x<=w, -w<=y<=w and 0<=z<=w because GLM_FORCE_DEPTH_ZERO_TO_ONE is set (vulkan depth range)
+    //   > the paper uses the openGL volume (-w<=z<=w), so the near plane is just the third row here
+    static Frustum from_matrix(const glm::mat4& view_proj) {
+        //glm matrices are column major so need to pull the rows out manually
+        const auto row = [&view_proj](const int r) {
+            return glm::vec4(view_proj[0][r], view_proj[1][r], view_proj[2][r], view_proj[3][r]);
+        };
+        const auto r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+        Frustum frustum;
+        frustum.planes[left_plane] = r3 + r0;
+        frustum.planes[right_plane] = r3 - r0;
+        frustum.planes[bottom_plane] = r3 + r1;
+        frustum.planes[top_plane] = r3 - r1;
+        frustum.planes[near_plane] = r2;
+        frustum.planes[far_plane] = r3 - r2;
+
+        //normalising so that the distances are in world units
+        for (auto& plane : frustum.planes) {
+            const float length = std::sqrt(plane.x*plane.x + plane.y*plane.y + plane.z*plane.z);
+            plane = plane / length;
+        }
+
+        return frustum;
+    }
+
+    //testing a box against all 6 planes
+    // - the box is outside if it is entirely behind any single plane
+    // - this is conservative: boxes near the corners of the frustum can be reported as visible when they are not
+    [[nodiscard]] bool intersects(const AABB& box) const {
+        const auto c = box.center();
+        const auto e = box.extent();
+        for (const auto& p : planes) {
+            //distance from the center of the box to the plane plus the projected radius of the box onto the plane normal
+            const float d = p.x*c.x + p.y*c.y + p.z*c.z + p.w + std::fabs(p.x)*e.x + std::fabs(p.y)*e.y + std::fabs(p.z)*e.z;
+            if (d < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //if the box is entirely inside the frustum
+    // - used to skip testing children when walking a tree of boxes
+    [[nodiscard]] bool contains(const AABB& box) const {
+        const auto c = box.center();
+        const auto e = box.extent();
+        for (const auto& p : planes) {
+            const float d = p.x*c.x + p.y*c.y + p.z*c.z + p.w - std::fabs(p.x)*e.x - std::fabs(p.y)*e.y - std::fabs(p.z)*e.z;
+            if (d < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif //VULKAN_ENGINE_FRUSTUM_HPP
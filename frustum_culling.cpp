@@ -0,0 +1,175 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "frustum_culling.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+size_t cull_range_scalar(const Frustum& frustum, const ObjectBounds& bounds, const size_t begin, const size_t end, uint32_t* out) {
+    size_t no_visible = 0;
+    for (size_t i = begin; i < end; i++) {
+        bool inside = true;
+        for (const auto& p : frustum.planes) {
+            //distance from the center of the box to the plane, plus the radius of the box projected onto the plane normal
+            // - if this is negative the whole box is behind the plane
+            const float d = p.x*bounds.center_x[i] + p.y*bounds.center_y[i] + p.z*bounds.center_z[i] + p.w
+                          + std::fabs(p.x)*bounds.extent_x[i] + std::fabs(p.y)*bounds.extent_y[i] + std::fabs(p.z)*bounds.extent_z[i];
+            if (d < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        //branchless write -- always writing the index but only moving forward if it is visible
+        out[no_visible] = static_cast<uint32_t>(i);
+        no_visible += inside;
+    }
+    return no_visible;
+}
+
+
+#ifdef __SSE2__
+size_t cull_range_sse(const Frustum& frustum, const ObjectBounds& bounds, const size_t begin, const size_t end, uint32_t* out) {
+    //broadcasting every component of every plane once, rather than once per group of objects
+    // - the absolute value of the normal is precomputed because it is the same for every box
+    __m128 n_x[6], n_y[6], n_z[6], n_w[6], a_x[6], a_y[6], a_z[6];
+    for (unsigned p = 0; p < 6; p++) {
+        const auto& plane = frustum.planes[p];
+        n_x[p] = _mm_set1_ps(plane.x); n_y[p] = _mm_set1_ps(plane.y); n_z[p] = _mm_set1_ps(plane.z); n_w[p] = _mm_set1_ps(plane.w);
+        a_x[p] = _mm_set1_ps(std::fabs(plane.x)); a_y[p] = _mm_set1_ps(std::fabs(plane.y)); a_z[p] = _mm_set1_ps(std::fabs(plane.z));
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t no_visible = 0;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        //the arrays are not aligned to 16 bytes, so using unaligned loads (these are as fast as aligned loads on anything recent)
+        const __m128 c_x = _mm_loadu_ps(&bounds.center_x[i]);
+        const __m128 c_y = _mm_loadu_ps(&bounds.center_y[i]);
+        const __m128 c_z = _mm_loadu_ps(&bounds.center_z[i]);
+        const __m128 e_x = _mm_loadu_ps(&bounds.extent_x[i]);
+        const __m128 e_y = _mm_loadu_ps(&bounds.extent_y[i]);
+        const __m128 e_z = _mm_loadu_ps(&bounds.extent_z[i]);
+
+        int mask = 0xF;
+        for (unsigned p = 0; p < 6 && mask != 0; p++) {
+            __m128 d = _mm_add_ps(_mm_mul_ps(n_x[p], c_x), n_w[p]);
+            d = _mm_add_ps(d, _mm_mul_ps(n_y[p], c_y));
+            d = _mm_add_ps(d, _mm_mul_ps(n_z[p], c_z));
+            d = _mm_add_ps(d, _mm_mul_ps(a_x[p], e_x));
+            d = _mm_add_ps(d, _mm_mul_ps(a_y[p], e_y));
+            d = _mm_add_ps(d, _mm_mul_ps(a_z[p], e_z));
+            mask &= _mm_movemask_ps(_mm_cmpge_ps(d, zero));    //1 bit per object that is in front of this plane
+        }
+
+        //writing out the index of every set bit
+        auto bits = static_cast<unsigned>(mask);
+        while (bits != 0) {
+            out[no_visible++] = static_cast<uint32_t>(i + std::countr_zero(bits));
+            bits &= bits - 1;
+        }
+    }
+
+    //the objects left over that don't fill an entire register
+    return no_visible + cull_range_scalar(frustum, bounds, i, end, out + no_visible);
+}
+#endif
+
+
+#ifdef __AVX2__
+size_t cull_range_avx2(const Frustum& frustum, const ObjectBounds& bounds, const size_t begin, const size_t end, uint32_t* out) {
+    //see the SSE version for comments
+    __m256 n_x[6], n_y[6], n_z[6], n_w[6], a_x[6], a_y[6], a_z[6];
+    for (unsigned p = 0; p < 6; p++) {
+        const auto& plane = frustum.planes[p];
+        n_x[p] = _mm256_set1_ps(plane.x); n_y[p] = _mm256_set1_ps(plane.y); n_z[p] = _mm256_set1_ps(plane.z); n_w[p] = _mm256_set1_ps(plane.w);
+        a_x[p] = _mm256_set1_ps(std::fabs(plane.x)); a_y[p] = _mm256_set1_ps(std::fabs(plane.y)); a_z[p] = _mm256_set1_ps(std::fabs(plane.z));
+    }
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t no_visible = 0;
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 c_x = _mm256_loadu_ps(&bounds.center_x[i]);
+        const __m256 c_y = _mm256_loadu_ps(&bounds.center_y[i]);
+        const __m256 c_z = _mm256_loadu_ps(&bounds.center_z[i]);
+        const __m256 e_x = _mm256_loadu_ps(&bounds.extent_x[i]);
+        const __m256 e_y = _mm256_loadu_ps(&bounds.extent_y[i]);
+        const __m256 e_z = _mm256_loadu_ps(&bounds.extent_z[i]);
+
+        int mask = 0xFF;
+        for (unsigned p = 0; p < 6 && mask != 0; p++) {
+#ifdef __FMA__
+            __m256 d = _mm256_fmadd_ps(n_x[p], c_x, n_w[p]);
+            d = _mm256_fmadd_ps(n_y[p], c_y, d);
+            d = _mm256_fmadd_ps(n_z[p], c_z, d);
+            d = _mm256_fmadd_ps(a_x[p], e_x, d);
+            d = _mm256_fmadd_ps(a_y[p], e_y, d);
+            d = _mm256_fmadd_ps(a_z[p], e_z, d);
+#else
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(n_x[p], c_x), n_w[p]);
+            d = _mm256_add_ps(d, _mm256_mul_ps(n_y[p], c_y));
+            d = _mm256_add_ps(d, _mm256_mul_ps(n_z[p], c_z));
+            d = _mm256_add_ps(d, _mm256_mul_ps(a_x[p], e_x));
+            d = _mm256_add_ps(d, _mm256_mul_ps(a_y[p], e_y));
+            d = _mm256_add_ps(d, _mm256_mul_ps(a_z[p], e_z));
+#endif
+            mask &= _mm256_movemask_ps(_mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+        }
+
+        auto bits = static_cast<unsigned>(mask);
+        while (bits != 0) {
+            out[no_visible++] = static_cast<uint32_t>(i + std::countr_zero(bits));
+            bits &= bits - 1;
+        }
+    }
+
+    //finishing off with the narrower kernel
+    return no_visible + cull_range_sse(frustum, bounds, i, end, out + no_visible);
+}
+#endif
+
+
+size_t cull_range(const Frustum& frustum, const ObjectBounds& bounds, const size_t begin, const size_t end, uint32_t* out) {
+#if defined(__AVX2__)
+    return cull_range_avx2(frustum, bounds, begin, end, out);
+#elif defined(__SSE2__)
+    return cull_range_sse(frustum, bounds, begin, end, out);
+#else
+    return cull_range_scalar(frustum, bounds, begin, end, out);
+#endif
+}
+
+
+
+void FrustumCuller::cull(const Frustum& frustum, const ObjectBounds& bounds, std::vector<uint32_t>& visible) {
+    const size_t no_objects = bounds.size();
+
+    //each chunk writes into its own scratch buffer
+    // - the buffers only ever grow so after the first few frames this never allocates
+    const size_t no_chunks = jobs.batch_count(no_objects, min_objects_per_thread);
+    if (thread_visible.size() < no_chunks) {
+        thread_visible.resize(no_chunks);
+        thread_counts.resize(no_chunks);
+    }
+    jobs.parallel_for(no_objects, min_objects_per_thread, [&](const size_t chunk, const size_t begin, const size_t end) {
+        auto& scratch = thread_visible[chunk];
+        if (scratch.size() < end - begin) {
+            scratch.resize(end - begin);
+        }
+        thread_counts[chunk] = cull_range(frustum, bounds, begin, end, scratch.data());
+    });
+
+    //joining the results -- the chunks are in order so the final list is sorted
+    visible.clear();
+    for (size_t chunk = 0; chunk < no_chunks; chunk++) {
+        visible.insert(visible.end(), thread_visible[chunk].begin(), thread_visible[chunk].begin() + static_cast<long>(thread_counts[chunk]));
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_FRUSTUM_CULLING_HPP
+#define VULKAN_ENGINE_FRUSTUM_CULLING_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include "frustum.hpp"
+#include "job_system.hpp"
+
+//the bounding boxes of every object in the scene
+// - stored as a structure of arrays (center and half-extent per axis) so the culling kernels can load 4 or 8 objects with a single instruction
+// - the index of an object is the index it was added at
+struct ObjectBounds {
+    std::vector<float> center_x, center_y, center_z;
+    std::vector<float> extent_x, extent_y, extent_z;
+
+    //returns the index of the new object
+    uint32_t add(const AABB& box) {
+        const auto index = static_cast<uint32_t>(center_x.size());
+        center_x.push_back(0.0f); center_y.push_back(0.0f); center_z.push_back(0.0f);
+        extent_x.push_back(0.0f); extent_y.push_back(0.0f); extent_z.push_back(0.0f);
+        set(index, box);
+        return index;
+    }
+
+    //updating the bounds of an existing object (e.g. after it moved)
+    void set(const uint32_t index, const AABB& box) {
+        const auto c = box.center();
+        const auto e = box.extent();
+        center_x[index] = c.x; center_y[index] = c.y; center_z[index] = c.z;
+        extent_x[index] = e.x; extent_y[index] = e.y; extent_z[index] = e.z;
+    }
+
+    void reserve(const size_t n) {
+        center_x.reserve(n); center_y.reserve(n); center_z.reserve(n);
+        extent_x.reserve(n); extent_y.reserve(n); extent_z.reserve(n);
+    }
+
+    void clear() {
+        center_x.clear(); center_y.clear(); center_z.clear();
+        extent_x.clear(); extent_y.clear(); extent_z.clear();
+    }
+
+    [[nodiscard]] size_t size() const {return center_x.size();}
+};
+
+
+//the culling kernels
+// - test the objects in [begin, end) against the frustum and write the indices of the visible objects to out
+// - out must have room for (end - begin) indices
+// - return the number of visible objects written
+// - all kernels give the same result, the SIMD versions just test 4 (SSE) or 8 (AVX2) objects at once
+size_t cull_range_scalar(const Frustum& frustum, const ObjectBounds& bounds, size_t begin, size_t end, uint32_t* out);
+#ifdef __SSE2__
+size_t cull_range_sse(const Frustum& frustum, const ObjectBounds& bounds, size_t begin, size_t end, uint32_t* out);
+#endif
+#ifdef __AVX2__
+size_t cull_range_avx2(const Frustum& frustum, const ObjectBounds& bounds, size_t begin, size_t end, uint32_t* out);
+#endif
+
+//the widest kernel the engine was compiled with
+// - AVX2 requires -mavx2 (or -march=native on a machine that has it), SSE2 is always available on x86-64
+size_t cull_range(const Frustum& frustum, const ObjectBounds& bounds, size_t begin, size_t end, uint32_t* out);
+constexpr std::string_view cull_kernel_name() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+
+//culls a set of objects against the camera frustum
+// - large sets are split into chunks that are tested on the workers of a JobSystem
+// - the visible indices are returned in increasing order so they can be used directly to record the draw commands
+struct FrustumCuller {
+    explicit FrustumCuller(JobSystem& j) : jobs(j) {}
+
+    //fills `visible' with the indices of the objects that are (at least partially) inside the frustum
+    void cull(const Frustum& frustum, const ObjectBounds& bounds, std::vector<uint32_t>& visible);
+
+    //below this many objects per thread it is faster to not split the work
+    static constexpr size_t min_objects_per_thread = 16384;
+
+private:
+    JobSystem& jobs;
+    std::vector<std::vector<uint32_t>> thread_visible;  //scratch output for each chunk (kept around to avoid reallocating every frame)
+    std::vector<size_t> thread_counts;                  //how many objects each chunk found visible
+};
+
+
+#endif //VULKAN_ENGINE_FRUSTUM_CULLING_HPP
@@ -0,0 +1,136 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "gpu_profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+void GpuProfiler::setup(const unsigned no_frames) {
+    if (!trace.enabled()) {
+        return;
+    }
+
+    //checking the graphics queue can write timestamps
+    // - timestampValidBits is 0 if it can't
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device.physical_device.get_device(), &queue_family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(device.physical_device.get_device(), &queue_family_count, queue_families.data());
+    const auto valid_bits = queue_families[queue_family.graphicsFamily.value()].timestampValidBits;
+    if (valid_bits == 0) {
+        return;
+    }
+    timestamp_mask = valid_bits >= 64 ? UINT64_MAX : (uint64_t{1} << valid_bits) - 1;
+
+    //the number of ns each tick of the timestamp is
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device.physical_device.get_device(), &properties);
+    ns_per_tick = static_cast<double>(properties.limits.timestampPeriod);
+
+    frames.resize(no_frames);
+    for (auto& frame : frames) {
+        VkQueryPoolCreateInfo poolInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkQueryPoolCreateInfo.html
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;  //sType must be VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = max_queries;
+        if (vkCreateQueryPool(device.get_device(), &poolInfo, nullptr, &frame.pool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create timestamp query pool");
+        }
+        frame.scopes.reserve(max_queries / 2);
+    }
+}
+
+void GpuProfiler::cleanup() {
+    for (unsigned i = 0; i < frames.size(); i++) {
+        collect(i);
+        vkDestroyQueryPool(device.get_device(), frames[i].pool, nullptr);
+    }
+    frames.clear();
+}
+
+void GpuProfiler::begin_frame(VkCommandBuffer command_buffer, const unsigned frame) {
+    if (!enabled()) {
+        return;
+    }
+    recording = frame;
+    auto& f = frames[frame];
+    f.scopes.clear();
+    f.queries_used = 0;
+    f.pending = false;
+    //queries must be reset before they are written again
+    vkCmdResetQueryPool(command_buffer, f.pool, 0, max_queries);
+}
+
+uint32_t GpuProfiler::begin_scope(VkCommandBuffer command_buffer, const char* name) {
+    if (!enabled()) {
+        return UINT32_MAX;
+    }
+    auto& f = frames[recording];
+    if (f.queries_used + 2 > max_queries) {
+        return UINT32_MAX;
+    }
+    //the time the GPU starts the commands after this
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, f.pool, f.queries_used);
+    f.scopes.push_back({name, f.queries_used});
+    f.queries_used += 2;    //saving a query for the end
+    return static_cast<uint32_t>(f.scopes.size() - 1);
+}
+
+void GpuProfiler::end_scope(VkCommandBuffer command_buffer, const uint32_t scope) {
+    if (!enabled() || scope == UINT32_MAX) {
+        return;
+    }
+    auto& f = frames[recording];
+    auto& s = f.scopes[scope];
+    s.end_query = s.begin_query + 1;
+    //the time every command before this has finished
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, f.pool, s.end_query);
+}
+
+void GpuProfiler::submitted(const int64_t time) {
+    if (!enabled()) {
+        return;
+    }
+    frames[recording].submit_time = time;
+    frames[recording].pending = true;
+}
+
+void GpuProfiler::collect(const unsigned frame) {
+    if (!enabled() || !frames[frame].pending) {
+        return;
+    }
+    auto& f = frames[frame];
+    f.pending = false;
+    if (f.queries_used == 0) {
+        return;
+    }
+
+    //the frame is finished so this doesn't wait
+    // - scopes that were never ended leave their end query unwritten, so not asking for every query to be available
+    std::array<uint64_t, max_queries * 2> results{};    //the value and if it is available for each query
+    const auto result = vkGetQueryPoolResults(device.get_device(), f.pool, 0, f.queries_used, sizeof(results), results.data(), 2 * sizeof(uint64_t),
+                                              VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        throw std::runtime_error("failed to read timestamp queries");
+    }
+    const auto available = [&](const uint32_t query) {return results[2 * query + 1] != 0;};
+    const auto time = [&](const uint32_t query) {return static_cast<int64_t>(static_cast<double>(results[2 * query] & timestamp_mask) * ns_per_tick);};
+
+    //lining the GPU up with the CPU
+    if (available(0)) {
+        gpu_to_cpu = std::max(gpu_to_cpu, f.submit_time - time(0));
+    }
+    if (gpu_to_cpu == INT64_MIN) {
+        return;
+    }
+
+    for (const auto& scope : f.scopes) {
+        if (scope.end_query == UINT32_MAX || !available(scope.begin_query) || !available(scope.end_query)) {
+            continue;
+        }
+        const auto start = time(scope.begin_query);
+        trace.add({scope.name, "gpu", Trace::gpu_thread, start + gpu_to_cpu, std::max<int64_t>(time(scope.end_query) - start, 0)});
+    }
+}
@@ -0,0 +1,79 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_GPU_PROFILER_HPP
+#define VULKAN_ENGINE_GPU_PROFILER_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+#include "logical_device.hpp"
+#include "queue_family.hpp"
+#include "trace.hpp"
+
+//timing parts of the frame on the GPU with timestamp queries
+// - a query pool for every frame in flight, so the timestamps are only read once the frame using the pool is known to be finished
+//   (i.e. reading them never waits for the GPU)
+// - the times are added to the trace, lined up with the CPU events
+// - does nothing unless the trace is enabled (and the graphics queue supports timestamps)
+// - https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/vkCmdWriteTimestamp.html
+struct GpuProfiler {
+    GpuProfiler(LogicalDevice &d, QueueFamily &q, TraceRecorder &t) : device(d), queue_family(q), trace(t) {}
+
+    void setup(unsigned no_frames);
+    //the device must be idle, the timestamps of frames not collected yet are added to the trace first
+    void cleanup();
+
+    [[nodiscard]] bool enabled() const {return !frames.empty();}
+
+    //starting a frame -- must be called before any scopes while recording its command buffer (outside a render pass)
+    // - the timestamps of the last frame that used `frame' must have been collected
+    void begin_frame(VkCommandBuffer command_buffer, unsigned frame);
+
+    //putting timestamps around part of the frame
+    // - name must live for the whole program (i.e. a string literal)
+    // - scopes are dropped if there are too many in a frame
+    [[nodiscard]] uint32_t begin_scope(VkCommandBuffer command_buffer, const char* name);
+    void end_scope(VkCommandBuffer command_buffer, uint32_t scope);
+
+    //the frame recorded last was submitted (Trace::now)
+    // - used to line up the GPU with the CPU in the trace
+    void submitted(int64_t time);
+
+    //adding the timestamps of the last frame that used `frame' to the trace
+    // - the frame must have finished on the GPU (e.g. its fence was waited on)
+    void collect(unsigned frame);
+
+    static constexpr uint32_t max_queries = 64;    //per frame, 2 for each scope
+
+private:
+    struct Scope {
+        const char* name;
+        uint32_t begin_query;
+        uint32_t end_query = UINT32_MAX;    //if the scope was ended
+    };
+    struct Frame {
+        VkQueryPool pool = VK_NULL_HANDLE;
+        std::vector<Scope> scopes;
+        uint32_t queries_used = 0;
+        int64_t submit_time = 0;
+        bool pending = false;   //submitted and not collected yet
+    };
+    std::vector<Frame> frames;
+    unsigned recording = 0;     //the frame being recorded
+
+    //converting timestamps to ns
+    double ns_per_tick = 1.0;
+    uint64_t timestamp_mask = UINT64_MAX;   //timestamps only have timestampValidBits bits
+    //what is added to the GPU times to put them on the CPU clock
+    // - a frame can't start on the GPU before it was submitted, so this is the smallest offset that is true for every frame
+    int64_t gpu_to_cpu = INT64_MIN;
+
+    LogicalDevice &device;
+    QueueFamily &queue_family;
+    TraceRecorder &trace;
+};
+
+
+#endif //VULKAN_ENGINE_GPU_PROFILER_HPP
@@ -7,16 +7,19 @@
 
 #include <string_view>
 #include "graphics_pipeline/shader.hpp"
+#include "graphics_pipeline/shader_cache.hpp"
+#include "graphics_pipeline/specialization_constants.hpp"
+#include "graphics_pipeline/pipeline_state.hpp"
 #include "logical_device.hpp"
-#include "swap_chain.hpp"
 #include "render_pass.hpp"
 #include "descriptor_set_layout.hpp"
+#include "pipeline_cache.hpp"
+#include "deletion_queue.hpp"
 
 #include "graphics_pipeline.hpp"
 #include "graphics_pipeline/vertex_input.hpp"
 #include "graphics_pipeline/input_assembly.hpp"
-#include "graphics_pipeline/viewport.hpp"
-#include "graphics_pipeline/scissor.hpp"
+#include "graphics_pipeline/dynamic_state.hpp"
 #include "graphics_pipeline/rasterizer.hpp"
 #include "graphics_pipeline/multisampling.hpp"
 #include "graphics_pipeline/color_blend.hpp"
@@ -24,18 +27,48 @@
 #include "vertex.hpp"
 
 #include <stdexcept>
+#include <utility>
+#include <array>
+#include <vector>
+#include <optional>
 
 template <typename T>
 struct GraphicsPipeline {
-    GraphicsPipeline(LogicalDevice &d, SwapChain &s, RenderPass &r, DescriptorSetLayout *l, const std::string_view vertex_shader_loc, const std::string_view frag_shader_loc)
-        : device(d), swap_chain(s), render_pass(r), descriptor_set_layout(l), vert_loc(vertex_shader_loc), frag_loc(frag_shader_loc) {}
+    //the pipelines don't depend on the size of the swapchain (the viewport and scissor are dynamic)
+    // - so they only need to be recreated if the render pass is
+    // - the specialization constants turn the shaders into a specific variant (e.g. with or without the MVP transform)
+    // - the state is the cull mode, depth test, etc used when the pipeline is bound (see bind)
+    // - push_constant_size is the number of bytes of push constants the vertex shader reads (e.g. per object data set with vkCmdPushConstants)
+    // - l are the descriptor set layouts in set order (the first is set=0 in the shader, see UBO::camera_set), and can be empty
+    GraphicsPipeline(LogicalDevice &d, RenderPass &r, PipelineCache &c, ShaderCache &sc, std::vector<DescriptorSetLayout*> l, const std::string_view vertex_shader_loc, const std::string_view frag_shader_loc,
+                     SpecializationConstants vertex_constants = {}, SpecializationConstants frag_constants = {}, const PipelineState pipeline_state = {}, const uint32_t push_constants = 0)
+        : vert_loc(vertex_shader_loc), frag_loc(frag_shader_loc), vert_constants(std::move(vertex_constants)), frag_constants(std::move(frag_constants)), state(pipeline_state),
+          push_constant_size(push_constants), device(d), render_pass(r), pipeline_cache(c), shader_cache(sc), descriptor_set_layouts(std::move(l)) {}
 
     void setup();
     void cleanup();
+    //destroying the pipeline once `frame' has finished on the GPU
+    // - setup can be called straight away to make a new pipeline (e.g. after the render pass changes or the shaders are reloaded)
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
+
+    //binding the pipeline to the command buffer
+    // - with extended dynamic state the pipelines state is also set here
+    // - bound_state is the state already set in this command buffer (empty when recording starts), only the states that differ from it are set
+    void bind(VkCommandBuffer command_buffer, std::optional<PipelineState>& bound_state);
+
+    //if the state can be changed each time the pipeline is bound
+    [[nodiscard]] bool has_dynamic_state() const {return device.extended_dynamic_state.enabled();}
 
     const std::string_view vert_loc;
     const std::string_view frag_loc;
 
+    SpecializationConstants vert_constants;
+    SpecializationConstants frag_constants;
+
+    PipelineState state;
+
+    const uint32_t push_constant_size;
+
     VkPipelineLayout pipeline_layout{};
     VkPipeline graphics_pipeline{};
 
@@ -43,46 +76,50 @@ struct GraphicsPipeline {
 
 private:
     LogicalDevice &device;
-    SwapChain &swap_chain;
     RenderPass &render_pass;
-    DescriptorSetLayout* descriptor_set_layout; //cannot have it as a reference because sometimes need nullptr
+    PipelineCache &pipeline_cache;
+    ShaderCache &shader_cache;
+    std::vector<DescriptorSetLayout*> descriptor_set_layouts;
 };
 
 
 template <typename T>
 void GraphicsPipeline<T>::setup() {
     //setting the uniforms and push constants in the shader
-    PipelineLayout pipeline_info{};
-    if (descriptor_set_layout == nullptr) {
-        pipeline_info = PipelineLayout(0, nullptr, 0, nullptr);
-    } else {
-        pipeline_info = PipelineLayout(1, &(descriptor_set_layout->get_layout()), 0, nullptr);
+    // - the push constants are only read by the vertex shader
+    VkPushConstantRange push_constant_range{};  //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkPushConstantRange.html
+    push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = push_constant_size;
+    const uint32_t no_push_constants = push_constant_size > 0 ? 1 : 0;
+    std::vector<VkDescriptorSetLayout> set_layouts;
+    set_layouts.reserve(descriptor_set_layouts.size());
+    for (auto* layout : descriptor_set_layouts) {
+        set_layouts.push_back(layout->get_layout());
     }
+    PipelineLayout pipeline_info(static_cast<uint32_t>(set_layouts.size()), set_layouts.data(), no_push_constants, &push_constant_range);
     //creating the pipeline
     const auto pipeline_layout_create_res = vkCreatePipelineLayout(device.get_device(), &pipeline_info.get_pipeline_stage(), nullptr, &pipeline_layout);   //pipeline_layout decleared in main header
     if (pipeline_layout_create_res != VK_SUCCESS) {
         throw std::runtime_error("failed to create pipeline layout!");
     }
 
-    Shader shader(device);
+    Shader shader(shader_cache);
     shader.setup(vert_loc, frag_loc);
 
-    const VkPipelineShaderStageCreateInfo shaderStages[] = {shader.get_vertex_pipeline_stage(), shader.get_frag_pipeline_stage()};
+    const VkPipelineShaderStageCreateInfo shaderStages[] = {shader.get_vertex_pipeline_stage(vert_constants.get_info()), shader.get_frag_pipeline_stage(frag_constants.get_info())};
 
 
     //specifying the settings for all fixed functions of the graphics pipeline
     //========================================================================
-    //where in the frame buffer to render to
-    Viewport viewpot(static_cast<float>(swap_chain.extent.width), static_cast<float>(swap_chain.extent.height) );
-    //the region rendered to to actually display
-    Scissor scissor(swap_chain.extent);
-
+    //where in the frame buffer to render to, and the region rendered to to actually display
+    // - these are dynamic (set in the command buffer) so only the number of them is given here
     VkPipelineViewportStateCreateInfo viewportState{};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewpot.get_pipeline_stage();
+    viewportState.pViewports = nullptr;     //ignored because the viewport is dynamic
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor.get_pipeline_stage();
+    viewportState.pScissors = nullptr;      //ignored because the scissor is dynamic
 
     //how the vertex are layed out
     //const auto bindingDescription = Vertex::TWOD_VC::getBindingDescription();
@@ -92,9 +129,11 @@ void GraphicsPipeline<T>::setup() {
 
     VertexInput vertex_input(1, &bindingDescription, attributeDescriptions.size(), attributeDescriptions.data());
     //the type of data being rendered (e.g. triangles or lines)
-    InputAssembly input_assembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    // - if extended dynamic state is used, this only sets the class of topology (e.g. triangles) and the exact one is set by bind
+    InputAssembly input_assembly(state.topology);
     //the rasterizing settings
-    Rasterizer rasterizer(VK_POLYGON_MODE_FILL, 1.0f, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+    // - the cull mode and front face are ignored if extended dynamic state is used
+    Rasterizer rasterizer(VK_POLYGON_MODE_FILL, 1.0f, state.cull_mode, state.front_face);
     //the multisampling settings (how much to multisample if at all)
     Multisample multisample(VK_SAMPLE_COUNT_1_BIT, VK_FALSE, 1.0f);
 
@@ -110,9 +149,9 @@ void GraphicsPipeline<T>::setup() {
     //specifying the depth stencil
     VkPipelineDepthStencilStateCreateInfo depthStencil{};                               //https://khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkPipelineDepthStencilStateCreateInfo.html
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;    //sType must be VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO
-    depthStencil.depthTestEnable = VK_TRUE;                                             //whether to used depth testing or not
-    depthStencil.depthWriteEnable = VK_TRUE;                                            //whether the new depth values should actually be written to the depth buffer
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;                                   //specifying the operator to use for the depth test
+    depthStencil.depthTestEnable = state.depth_test;                                    //whether to used depth testing or not (ignored if extended dynamic state is used)
+    depthStencil.depthWriteEnable = state.depth_write;                                  //whether the new depth values should actually be written to the depth buffer (ignored if extended dynamic state is used)
+    depthStencil.depthCompareOp = state.depth_compare;                                  //specifying the operator to use for the depth test (ignored if extended dynamic state is used)
                                                                                         // - https://khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkCompareOp.html
     depthStencil.depthBoundsTestEnable = VK_FALSE;                                      //only keep fragments within a certain rage
     depthStencil.minDepthBounds = 0.0f;                                                 //lower bound on the depth of fragments to keep
@@ -123,8 +162,15 @@ void GraphicsPipeline<T>::setup() {
 
 
 
-    //can also set the Dynamic stateVkRenderPass
+    //the states set when recording the command buffer
+    // - the viewport and scissor depend on the size of the swapchain, so making them dynamic means the pipeline survives a window resize
     //https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Fixed_functions
+    // - with extended dynamic state the states in PipelineState are also dynamic (set in bind)
+    const std::array<VkDynamicState, 8> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR,
+                                                          VK_DYNAMIC_STATE_CULL_MODE, VK_DYNAMIC_STATE_FRONT_FACE, VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+                                                          VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE, VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE, VK_DYNAMIC_STATE_DEPTH_COMPARE_OP};
+    const uint32_t no_dynamic_states = has_dynamic_state() ? 8 : 2;
+    DynamicState dynamic_state(no_dynamic_states, dynamic_states.data());
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -138,7 +184,7 @@ void GraphicsPipeline<T>::setup() {
     pipelineInfo.pMultisampleState = &multisample.get_pipeline_stage();
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &color_blend_state.get_pipeline_stage();
-    pipelineInfo.pDynamicState = nullptr; // no currently used
+    pipelineInfo.pDynamicState = &dynamic_state.get_pipeline_stage();
     //description of the binding locations (i.e. how uniforms work)
     pipelineInfo.layout = pipeline_layout;
     //description of the render passes
@@ -152,13 +198,58 @@ void GraphicsPipeline<T>::setup() {
 
     //acutally creating the pipeline
     // - can create multiple pipelines all in a single call
-    const auto pipeline_create_res = vkCreateGraphicsPipelines(device.get_device(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphics_pipeline);
+    // - the pipeline cache lets the driver skip compiling the pipeline if it has been created before (either this run or a previous one)
+    const auto pipeline_create_res = vkCreateGraphicsPipelines(device.get_device(), pipeline_cache.get_pipeline_cache(), 1, &pipelineInfo, nullptr, &graphics_pipeline);
     if (pipeline_create_res != VK_SUCCESS) {
         throw std::runtime_error("failed to create graphics pipeline!");
     }
 
-    //destroying the shader modules
-    shader.cleanup();
+    //the shader modules are kept in the shader cache so they can be reused when the pipeline is recreated
+}
+
+template <typename T>
+void GraphicsPipeline<T>::bind(VkCommandBuffer command_buffer, std::optional<PipelineState>& bound_state) {
+    //VK_PIPELINE_BIND_POINT_GRAPHICS because for graphics and not for compute
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
+
+    if (!has_dynamic_state()) {
+        return;
+    }
+
+    //dynamic state is not part of the pipeline, so the values set by the previous pipeline are still there
+    // - so only the states that are different need to be set
+    // - the states are undefined at the start of a command buffer, so the first bind sets all of them
+    const auto& eds = device.extended_dynamic_state;
+    const bool set_all = !bound_state.has_value();
+    if (set_all || bound_state->cull_mode != state.cull_mode) {
+        eds.set_cull_mode(command_buffer, state.cull_mode);
+    }
+    if (set_all || bound_state->front_face != state.front_face) {
+        eds.set_front_face(command_buffer, state.front_face);
+    }
+    if (set_all || bound_state->topology != state.topology) {
+        eds.set_primitive_topology(command_buffer, state.topology);
+    }
+    if (set_all || bound_state->depth_test != state.depth_test) {
+        eds.set_depth_test_enable(command_buffer, state.depth_test);
+    }
+    if (set_all || bound_state->depth_write != state.depth_write) {
+        eds.set_depth_write_enable(command_buffer, state.depth_write);
+    }
+    if (set_all || bound_state->depth_compare != state.depth_compare) {
+        eds.set_depth_compare_op(command_buffer, state.depth_compare);
+    }
+    bound_state = state;
+}
+
+template <typename T>
+void GraphicsPipeline<T>::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    deletion_queue.push(frame, [d = device.get_device(), old_pipeline = graphics_pipeline, old_layout = pipeline_layout] {
+        vkDestroyPipeline(d, old_pipeline, nullptr);
+        vkDestroyPipelineLayout(d, old_layout, nullptr);
+    });
+    graphics_pipeline = VK_NULL_HANDLE;
+    pipeline_layout = VK_NULL_HANDLE;
 }
 
 template <typename T>
@@ -0,0 +1,29 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_DYNAMIC_STATE_HPP
+#define VULKAN_ENGINE_DYNAMIC_STATE_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+//the parts of the pipeline that are set when recording the command buffer rather than when creating the pipeline
+// - e.g. the viewport and scissor, so the pipeline doesn't need to be recreated when the window is resized
+// - the values given in the pipeline for these states are ignored
+struct DynamicState {
+    //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkPipelineDynamicStateCreateInfo.html
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+
+    DynamicState(const uint32_t no_states, const VkDynamicState* states) {
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;  //sType must be VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO
+        dynamicState.dynamicStateCount = no_states;     //the number of states
+        dynamicState.pDynamicStates = states;           //the states that are dynamic
+                                                        // - see https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkDynamicState.html
+    }
+
+    [[nodiscard]] VkPipelineDynamicStateCreateInfo& get_pipeline_stage() {return dynamicState;}
+};
+
+
+#endif //VULKAN_ENGINE_DYNAMIC_STATE_HPP
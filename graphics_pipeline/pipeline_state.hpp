@@ -0,0 +1,26 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_PIPELINE_STATE_HPP
+#define VULKAN_ENGINE_PIPELINE_STATE_HPP
+
+#include <vulkan/vulkan.h>
+
+//the fixed function state that can be dynamic with extended dynamic state (see extended_dynamic_state.hpp)
+// - if the device supports it, these are set when the pipeline is bound, so pipelines only differing in these can be shared
+// - otherwise they are baked into the pipeline when it is created
+struct PipelineState {
+    VkCullModeFlags cull_mode = VK_CULL_MODE_BACK_BIT;                      //what side of the polygon to cull
+    VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;               //how to determine if triangles are front-facing
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;     //the type of data being rendered
+                                                                            // - if dynamic, can only be changed to a topology of the same class (e.g. triangle list to triangle strip)
+    VkBool32 depth_test = VK_TRUE;                                          //whether to used depth testing or not
+    VkBool32 depth_write = VK_TRUE;                                         //whether the new depth values should actually be written to the depth buffer
+    VkCompareOp depth_compare = VK_COMPARE_OP_LESS;                         //the operator to use for the depth test
+
+    bool operator==(const PipelineState&) const = default;
+};
+
+
+#endif //VULKAN_ENGINE_PIPELINE_STATE_HPP
@@ -5,32 +5,27 @@
 #ifndef VULKAN_ENGINE_SHADER_HPP
 #define VULKAN_ENGINE_SHADER_HPP
 
-#include <vector>
 #include <string_view>
 #include <vulkan/vulkan.h>
-#include "../logical_device.hpp"
+#include "shader_cache.hpp"
 
 struct Shader {
-    explicit Shader(LogicalDevice & d) : device(d) {}
+    explicit Shader(ShaderCache & c) : shader_cache(c) {}
 
     //thin wrappers around the shader bytecode
     // - shaders must be wrapped in a VkShaderModule before it can be passed to the graphics pipeline
+    // - the modules are owned by the shader cache so don't need to be destroyed here
     VkShaderModule vertShaderModule{};
     VkShaderModule fragShaderModule{};
 
-    static std::vector<char> readShader(const std::string_view& filename);  //reads the shader bytecode in from disk
-
     void setup(const std::string_view& vert_file, const std::string_view& frag_file);
 
-    [[nodiscard]] VkPipelineShaderStageCreateInfo get_vertex_pipeline_stage() const;
-    [[nodiscard]] VkPipelineShaderStageCreateInfo get_frag_pipeline_stage() const;
-
-    void cleanup();
+    //the specialization info is nullptr if the shader has no specialization constants
+    [[nodiscard]] VkPipelineShaderStageCreateInfo get_vertex_pipeline_stage(const VkSpecializationInfo* specialization = nullptr) const;
+    [[nodiscard]] VkPipelineShaderStageCreateInfo get_frag_pipeline_stage(const VkSpecializationInfo* specialization = nullptr) const;
 
 private:
-    LogicalDevice &device;
-
-    void createShaderModule(const std::vector<char> &code, VkShaderModule &shader_module);    //small helper function to create the VkShaderModules
+    ShaderCache &shader_cache;
 };
 
 
@@ -0,0 +1,153 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "shader_cache.hpp"
+#include <algorithm>
+#include <cstdlib>  //for getenv
+#include <cstring>
+#include <stdexcept>
+
+#ifdef EMBED_SPIRV
+#include <embedded_shaders.hpp>     //generated at build time by cmake/embed_spirv.cmake
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <vector>
+#endif
+
+uint64_t ShaderCache::hash(const void* data, const size_t size) {
+    //the hash is mixed in the size so files that are a prefix of each other don't collide as easily
+    const auto bytes = static_cast<const unsigned char*>(data);
+    uint64_t h = 14695981039346656037ull ^ size;
+    for (size_t i = 0; i < size; i++) {
+        h ^= bytes[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+VkShaderModule ShaderCache::get_locked(const uint32_t* code, const size_t code_size) {
+    if (code_size == 0 || code_size % 4 != 0) {
+        throw std::runtime_error("SPIR-V size must be a non-zero multiple of 4");
+    }
+
+    const Key key{hash(code, code_size), code_size};
+    const auto [first, last] = modules.equal_range(key);
+    for (auto existing = first; existing != last; ++existing) {
+        if (std::memcmp(existing->second.code.data(), code, code_size) == 0) {
+            return existing->second.module;
+        }
+    }
+
+    //specifying the shader bytecode to create the module from
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO; //sType must be VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO
+    createInfo.codeSize = code_size;    //number of bytes in the shader
+    createInfo.pCode = code;            //the bytecode
+
+    VkShaderModule shader_module{};
+    if (vkCreateShaderModule(device.get_device(), &createInfo, nullptr, &shader_module) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shader module");
+    }
+    modules.emplace(key, Module{std::vector<uint32_t>(code, code + code_size / 4), shader_module});
+    return shader_module;
+}
+
+VkShaderModule ShaderCache::get(const uint32_t* code, const size_t code_size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return get_locked(code, code_size);
+}
+
+VkShaderModule ShaderCache::get(const std::string_view file) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string filename(file);
+    if (const auto existing = files.find(filename); existing != files.end()) {
+        return existing->second;
+    }
+
+    //the shaders can be loaded from a different directory without rebuilding (e.g. while working on them)
+    // - only the name of the file is used, the directory it was meant to be in is ignored
+    const auto file_name = file.substr(file.find_last_of('/') + 1);
+    VkShaderModule shader_module{};
+    if (const char* override_dir = std::getenv(override_variable)) {
+        shader_module = load_file(std::string(override_dir) + "/" + std::string(file_name));
+    } else {
+        bool embedded = false;
+#ifdef EMBED_SPIRV
+        //no need to touch the disk if the shader was compiled into the program
+        const auto entry = std::find_if(std::begin(EmbeddedShaders::entries), std::end(EmbeddedShaders::entries),
+                                        [&](const EmbeddedShaders::Entry& e) {return e.file_name == file_name;});
+        if (entry != std::end(EmbeddedShaders::entries)) {
+            shader_module = get_locked(entry->code, entry->size);
+            embedded = true;
+        }
+#endif
+        if (!embedded) {
+            shader_module = load_file(filename);
+        }
+    }
+
+    files.emplace(std::move(filename), shader_module);
+    return shader_module;
+}
+
+VkShaderModule ShaderCache::load_file(const std::string& filename) {
+#if defined(__unix__) || defined(__APPLE__)
+    //mapping the file into memory rather than reading it
+    // - the driver reads the SPIR-V straight out of the page cache, no copy is made
+    // - mmap'd memory is page aligned so it is fine to pass as uint32_t
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("failed to read shader");
+    }
+    struct stat file_stats{};
+    if (fstat(fd, &file_stats) != 0 || file_stats.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("failed to read shader");
+    }
+    const auto file_size = static_cast<size_t>(file_stats.st_size);
+    void* mapped = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  //the mapping keeps the file open
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("failed to map shader");
+    }
+
+    VkShaderModule shader_module{};
+    try {
+        shader_module = get_locked(static_cast<const uint32_t*>(mapped), file_size);
+    } catch (...) {
+        munmap(mapped, file_size);
+        throw;
+    }
+    munmap(mapped, file_size);  //vulkan copies the code when making the module so the file isn't needed any more
+#else
+    //no mmap so just reading the file
+    std::ifstream shader_file(filename, std::ios::ate | std::ios::binary);  //::ate so get the file size for free
+    if (!shader_file.is_open()) {
+        throw std::runtime_error("failed to read shader");
+    }
+    const auto file_size = static_cast<size_t>(shader_file.tellg());
+    std::vector<uint32_t> code((file_size + 3) / 4);    //uint32_t so the data is correctly aligned
+    shader_file.seekg(0);
+    shader_file.read(reinterpret_cast<char*>(code.data()), static_cast<long>(file_size));
+    const auto shader_module = get_locked(code.data(), file_size);
+#endif
+
+    return shader_module;
+}
+
+void ShaderCache::cleanup() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& [key, cached] : modules) {
+        vkDestroyShaderModule(device.get_device(), cached.module, nullptr);
+    }
+    modules.clear();
+    files.clear();
+}
@@ -0,0 +1,74 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_SHADER_CACHE_HPP
+#define VULKAN_ENGINE_SHADER_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../logical_device.hpp"
+
+//owns every VkShaderModule the program uses
+// - modules are keyed by a hash and the size of their SPIR-V, so pipelines that use the same shader (even from different files) share a module
+//   > a copy of the SPIR-V is kept with every module and compared on a hit, so two shaders whose hashes collide still get their own modules
+// - modules live until cleanup, so recreating a pipeline (e.g. on resize) doesn't reread or recompile its shaders
+// - shaders compiled into the program (EMBED_SPIRV) are used straight from memory
+//   > setting VULKAN_ENGINE_SHADER_DIR loads them from that directory instead, so shaders can be changed without rebuilding
+// - other shaders are read through a read-only memory map rather than copied into a buffer
+// - safe to use from multiple threads (pipelines are compiled in parallel)
+struct ShaderCache {
+    explicit ShaderCache(LogicalDevice &d) : device(d) {}
+
+    //the module for the SPIR-V in the file
+    // - only reads the file the first time it is asked for
+    // - if the shader is embedded (and not overridden) the file is never read
+    VkShaderModule get(std::string_view file);
+
+    //the module for SPIR-V already in memory
+    // - code_size is in bytes and must be a multiple of 4
+    VkShaderModule get(const uint32_t* code, size_t code_size);
+
+    void cleanup();
+
+    [[nodiscard]] size_t size() const {return modules.size();}
+
+    //the environment variable to load shaders from a directory instead of the embedded copies
+    static constexpr const char* override_variable = "VULKAN_ENGINE_SHADER_DIR";
+
+    //FNV-1a -- quick, and good enough to tell shaders apart
+    [[gnu::pure]] static uint64_t hash(const void* data, size_t size);
+
+private:
+    LogicalDevice &device;
+
+    struct Key {
+        uint64_t hash;
+        size_t code_size;
+
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {return static_cast<size_t>(key.hash);}
+    };
+    struct Module {
+        std::vector<uint32_t> code;     //to check a hit really is the same SPIR-V
+        VkShaderModule module;
+    };
+
+    std::mutex mutex;
+    std::unordered_multimap<Key, Module, KeyHash> modules;  //hash and size of the SPIR-V -> modules with that hash (more than one only if they collide)
+    std::unordered_map<std::string, VkShaderModule> files;  //file that has already been loaded -> module
+
+    //must be called with the mutex locked
+    VkShaderModule get_locked(const uint32_t* code, size_t code_size);
+    VkShaderModule load_file(const std::string& filename);
+};
+
+
+#endif //VULKAN_ENGINE_SHADER_CACHE_HPP
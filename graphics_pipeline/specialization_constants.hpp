@@ -0,0 +1,70 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_SPECIALIZATION_CONSTANTS_HPP
+#define VULKAN_ENGINE_SPECIALIZATION_CONSTANTS_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <cstring>  //for memcpy
+#include <type_traits>
+#include <vector>
+
+//values for the `layout(constant_id = x) const' variables in a shader
+// - these are set when the pipeline is created, so one shader can be turned into many pipelines (e.g. with and without texturing)
+// - the driver compiles each pipeline with the constants known, so branches on them are free (the unused side is removed)
+// - only the types glsl allows for specialization constants can be set (bool, int, uint and float)
+struct SpecializationConstants {
+    template <typename T>
+    SpecializationConstants& set(const uint32_t constant_id, const T value) {
+        static_assert(std::is_same_v<T, bool> || std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, float>,
+                      "specialization constants must be bool, int32_t, uint32_t or float");
+        //bools are 32 bits in SPIR-V
+        if constexpr (std::is_same_v<T, bool>) {
+            return set_bytes(constant_id, static_cast<VkBool32>(value ? VK_TRUE : VK_FALSE));
+        } else {
+            return set_bytes(constant_id, value);
+        }
+    }
+
+    [[nodiscard]] bool empty() const {return entries.empty();}
+
+    //the info to give to the shader stage
+    // - points into this object so it must outlive the pipeline creation
+    [[nodiscard]] const VkSpecializationInfo* get_info() {
+        if (entries.empty()) {
+            return nullptr;
+        }
+        info.mapEntryCount = static_cast<uint32_t>(entries.size());     //the number of constants
+        info.pMapEntries = entries.data();                              //where each constant is in the data
+        info.dataSize = data.size();                                    //the size of all the constants in bytes
+        info.pData = data.data();                                       //the values of the constants
+        return &info;
+    }
+
+private:
+    //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkSpecializationMapEntry.html
+    std::vector<VkSpecializationMapEntry> entries;
+    std::vector<unsigned char> data;
+    VkSpecializationInfo info{};     //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkSpecializationInfo.html
+
+    template <typename T>
+    SpecializationConstants& set_bytes(const uint32_t constant_id, const T value) {
+        //setting the same constant again just replaces its value
+        for (const auto& entry : entries) {
+            if (entry.constantID == constant_id && entry.size == sizeof(T)) {
+                std::memcpy(data.data() + entry.offset, &value, sizeof(T));
+                return *this;
+            }
+        }
+        const auto offset = static_cast<uint32_t>(data.size());
+        data.resize(data.size() + sizeof(T));
+        std::memcpy(data.data() + offset, &value, sizeof(T));
+        entries.push_back({constant_id, offset, sizeof(T)});
+        return *this;
+    }
+};
+
+
+#endif //VULKAN_ENGINE_SPECIALIZATION_CONSTANTS_HPP
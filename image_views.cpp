@@ -4,6 +4,7 @@
 
 #include "image_views.hpp"
 #include <stdexcept>
+#include <utility>
 
 void createImageView(LogicalDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView &imageView) {
     VkImageViewCreateInfo createInfo{};
@@ -50,3 +51,12 @@ void ImageViews::cleanup() {
         vkDestroyImageView(device.get_device(), imageView, nullptr);
     }
 }
+
+void ImageViews::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    deletion_queue.push(frame, [d = device.get_device(), old_views = std::move(swapChainImageViews)] {
+        for (const auto &imageView : old_views) {
+            vkDestroyImageView(d, imageView, nullptr);
+        }
+    });
+    swapChainImageViews.clear();
+}
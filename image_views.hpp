@@ -27,6 +27,9 @@ struct ImageViews {
 
     void setup();
     void cleanup();
+    //destroying the views once `frame' has finished on the GPU
+    // - setup can be called straight away to make new views
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
 };
 
 
@@ -13,6 +13,7 @@
 #include "vertex.hpp"
 #include <cstring>  //for memcpy
 #include "buffer.hpp"
+#include "deletion_queue.hpp"
 
 
 
@@ -86,6 +87,17 @@ struct IndexBuffer {
         vkFreeMemory(device.get_device(), indexBufferMemory, nullptr);
     }
 
+    //destroying the buffer once `frame' has finished on the GPU
+    // - setup can be called straight away to upload new indices (e.g. when streaming in a new mesh)
+    void retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+        deletion_queue.push(frame, [d = device.get_device(), old_buffer = indexBuffer, old_memory = indexBufferMemory] {
+            vkDestroyBuffer(d, old_buffer, nullptr);
+            vkFreeMemory(d, old_memory, nullptr);
+        });
+        indexBuffer = VK_NULL_HANDLE;
+        indexBufferMemory = VK_NULL_HANDLE;
+    }
+
 
 
 
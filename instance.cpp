@@ -10,7 +10,7 @@
 #include "debug_callback.hpp"
 
 
-void Instance::create() {
+void Instance::create(const bool headless) {
     //filling a struct with some information about out application
     VkApplicationInfo appInfo{};    //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkApplicationInfo.html
     appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO; //sType must be VK_STRUCTURE_TYPE_APPLICATION_INFO
@@ -23,7 +23,7 @@ void Instance::create() {
 
     //getting the global extensions needed
     // (global means for the entire program)
-    const auto extensions = getRequiredExtensions();
+    const auto extensions = getRequiredExtensions(headless);
 
 
     //checking if all extensions requested are available
@@ -150,13 +150,17 @@ bool Instance::checkValidationLayerSupport() {
 #endif
 
 //https://www.khronos.org/registry/vulkan/ has a list of all extensions
-std::vector<const char*> Instance::getRequiredExtensions() {
+std::vector<const char*> Instance::getRequiredExtensions(const bool headless) {
     //first getting the required extensions for GLFW to work
-    unsigned glfw_extension_count = 0;
-    const char** glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
-
-    //putting the glw extensions into a vector to return
-    std::vector<const char*> extensions(glfw_extensions, glfw_extensions + glfw_extension_count);
+    // - without a window there is no surface, so GLFW (and the surface extensions) are not needed
+    std::vector<const char*> extensions;
+    if (!headless) {
+        unsigned glfw_extension_count = 0;
+        const char** glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+
+        //putting the glw extensions into a vector to return
+        extensions.assign(glfw_extensions, glfw_extensions + glfw_extension_count);
+    }
 
 
     //extensions needed for validation layers
@@ -28,9 +28,10 @@ struct Instance {
 
     //getting the required extensions
     // currently those needed by GLFW and by validation layers
-    static std::vector<const char*> getRequiredExtensions();
+    // - GLFW is not used when headless
+    static std::vector<const char*> getRequiredExtensions(bool headless);
 
-    void create();
+    void create(bool headless = false);
 
     inline void cleanup() const {vkDestroyInstance(instance, nullptr);}   //nullptr is for custom memory allocation
 
@@ -45,7 +46,8 @@ private:
     const unsigned application_version = VK_MAKE_VERSION(1, 0, 0);  //developer-supplied version number of the application
     const char* engine_name = "no_engine";  //the name of the engine used to create the application (its default is NULL)
     const unsigned engine_version = VK_MAKE_VERSION(1, 0, 0);   //the version number of the engine
-    const unsigned vulkan_version = VK_API_VERSION_1_0; //the highest version of vulkan that the application is designed to use
+    const unsigned vulkan_version = VK_API_VERSION_1_3; //the highest version of vulkan that the application is designed to use
+                                                        // - the device can support a lower version, optional features are only used if the device supports them (e.g. extended dynamic state)
 
 };
 
@@ -0,0 +1,244 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "job_system.hpp"
+
+#include <iterator>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    //which queue the current thread pushes to and pops from first
+    // - workers use their own queue, every other thread (or a worker of a different JobSystem) uses the shared queue
+    thread_local const JobSystem* current_system = nullptr;
+    thread_local unsigned current_queue = 0;
+}
+
+
+JobSystem::JobSystem(const unsigned threads, const bool pin_threads) {
+    //hardware_concurrency can return 0 if it is not known
+    const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned no_workers = std::max(1u, threads != 0 ? threads : hardware_threads - 1);
+
+    //the queues must all exist before any worker starts stealing from them
+    queues.reserve(no_workers + 1);
+    for (unsigned i = 0; i < no_workers + 1; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    workers.reserve(no_workers);
+    for (unsigned i = 0; i < no_workers; i++) {
+        workers.emplace_back(&JobSystem::worker, this, i);
+#ifdef __linux__
+        //keeping each worker on its own core so its caches stay warm
+        // - core 0 is left for the main thread, the workers wrap around if there are more of them than cores
+        if (pin_threads) {
+            cpu_set_t cores;
+            CPU_ZERO(&cores);
+            CPU_SET((i + 1) % hardware_threads, &cores);
+            pthread_setaffinity_np(workers.back().native_handle(), sizeof(cores), &cores);
+        }
+#else
+        (void)pin_threads;
+#endif
+    }
+}
+
+JobSystem::~JobSystem() {
+    //the workers finish every queued job before stopping
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+
+void JobSystem::run(std::function<void()> job, JobCounter* counter) {
+    if (counter != nullptr) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push({std::move(job), counter});
+}
+
+void JobSystem::run_after(JobCounter& dependency, std::function<void()> job, JobCounter* counter) {
+    if (counter != nullptr) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        //the last job of the dependency takes its continuations with this lock held (see finish), so this can't be missed
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (!dependency.done()) {
+            dependency.continuations.push_back({std::move(job), counter});
+            return;
+        }
+    }
+    push({std::move(job), counter});
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    help_until_done(counter);
+
+    std::lock_guard<std::mutex> lock(counter.mutex);
+    if (counter.error) {
+        auto error = counter.error;
+        counter.error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::help_until_done(JobCounter& counter) {
+    while (!counter.done()) {
+        //helping out rather than just waiting
+        // - only with the counter's own jobs, anything else (e.g. a pipeline being compiled) could take much longer than what is being waited on
+        const auto seen = pushes.load(std::memory_order_acquire);
+        Job job;
+        if (try_pop_for(counter, job)) {
+            execute(job);
+            continue;
+        }
+        //the rest of the counter's jobs are running on other threads, or are continuations that haven't been queued yet
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        waiter_wake.wait(lock, [&] {return counter.done() || pushes.load(std::memory_order_acquire) != seen;});
+    }
+
+    //the thread that finished the last job may still be holding the counter's lock
+    // - waiting for it to let go, since the counter is usually destroyed as soon as this returns
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+
+void JobSystem::worker(const unsigned index) {
+    current_system = this;
+    current_queue = index;
+
+    while (true) {
+        Job job;
+        if (try_pop(job)) {
+            execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] {return stopping || queued.load(std::memory_order_acquire) > 0;});
+        if (stopping && queued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void JobSystem::push(Job job) {
+    const unsigned index = current_system == this ? current_queue : shared_queue();
+    {
+        auto& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    pushes.fetch_add(1, std::memory_order_release);
+
+    //taking the lock so a thread that just found nothing to do is either already asleep or will see the new job
+    // - every waiting thread is woken because only the ones waiting on this job's counter can run it
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_one();
+    waiter_wake.notify_all();
+}
+
+bool JobSystem::try_pop(Job& job) {
+    const unsigned shared = shared_queue();
+    const unsigned own = current_system == this ? current_queue : shared;
+
+    //a worker takes the newest job from its own queue, the shared queue is first in first out
+    {
+        auto& queue = *queues[own];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            if (own == shared) {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+            } else {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    //stealing the oldest job from the other queues
+    // - starting from the next queue along so every thread doesn't go after the same one
+    for (size_t i = 1; i < queues.size(); i++) {
+        auto& queue = *queues[(own + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::try_pop_for(const JobCounter& counter, Job& job) {
+    //looking at the newest jobs first, they are the most likely to still be in cache
+    for (auto& queue : queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        const auto found = std::find_if(queue->jobs.rbegin(), queue->jobs.rend(), [&](const Job& j) {return j.counter == &counter;});
+        if (found != queue->jobs.rend()) {
+            job = std::move(*found);
+            queue->jobs.erase(std::next(found).base());
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job) {
+    std::exception_ptr error;
+    try {
+        job.work();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    job.work = nullptr;     //destroying anything the job captured before anyone waiting on it is woken
+    if (job.counter != nullptr) {
+        finish(*job.counter, error);
+    }
+}
+
+void JobSystem::finish(JobCounter& counter, std::exception_ptr error) {
+    std::vector<JobCounter::Continuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        if (error && !counter.error) {
+            counter.error = std::move(error);
+        }
+        if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        ready = std::move(counter.continuations);
+        counter.continuations.clear();
+    }
+    //the counter may have been destroyed from here on (see help_until_done)
+
+    //starting the jobs that were waiting on this counter
+    for (auto& continuation : ready) {
+        push({std::move(continuation.work), continuation.counter});
+    }
+
+    //waking the threads waiting on the counter
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    waiter_wake.notify_all();
+}
@@ -0,0 +1,166 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_JOB_SYSTEM_HPP
+#define VULKAN_ENGINE_JOB_SYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct JobSystem;
+
+//the number of jobs that haven't finished yet
+// - given to JobSystem::run to track the jobs, and to JobSystem::wait to block until they are all done
+// - jobs given to JobSystem::run_after wait for a counter to reach 0 before they are started (i.e. their dependencies)
+// - also keeps the first exception thrown by any of its jobs, which is rethrown by JobSystem::wait
+// - must outlive every job that uses it
+struct JobCounter {
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    [[nodiscard]] bool done() const {return pending.load(std::memory_order_acquire) == 0;}
+
+private:
+    friend struct JobSystem;
+
+    struct Continuation {
+        std::function<void()> work;
+        JobCounter* counter;
+    };
+
+    std::atomic<size_t> pending{0};
+    std::mutex mutex;                           //protects everything below (and the last decrement of pending)
+    std::vector<Continuation> continuations;    //jobs waiting for this counter to reach 0
+    std::exception_ptr error;
+};
+
+
+//runs jobs on a pool of worker threads
+// - every worker has its own queue of jobs, new jobs made by a worker go on its own queue and are taken from the back (so the most recent, and
+//   likely still in cache, job is run next)
+// - a worker with nothing to do steals the oldest job from another worker's queue
+// - jobs made by any other thread (e.g. the main or render thread) go on a shared queue that every worker steals from
+// - a thread that waits for jobs runs the jobs it is waiting on itself, so waiting inside a job doesn't deadlock and the main thread isn't idle
+//   > it only runs jobs tracked by the counter it waits on, so e.g. a short parallel_for never ends up compiling an unrelated pipeline
+// - a single pool is shared by the renderer (transforms, pipeline compilation, texture decoding)
+//   > FrustumCuller can also use it to cull a flat list of objects, but the renderer culls with its SceneBVH instead
+struct JobSystem {
+    //threads is the number of worker threads, 0 means one less than the number of hardware threads (the thread that waits does work too)
+    // - if pin_threads is true every worker is kept on its own core (linux only, ignored elsewhere)
+    explicit JobSystem(unsigned threads = 0, bool pin_threads = false);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    //queues a job
+    // - counter (if given) is increased now and decreased when the job has finished
+    // - exceptions are passed on through the counter, so a job that can throw should have one
+    void run(std::function<void()> job, JobCounter* counter = nullptr);
+    void run(std::function<void()> job, JobCounter& counter) {run(std::move(job), &counter);}
+
+    //queues a job once every job tracked by `dependency' has finished
+    // - counter is increased now (not when the job is started) so waiting on it also waits for the dependency
+    void run_after(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+    //runs jobs until every job tracked by the counter has finished
+    // - rethrows the first exception thrown by any of them
+    void wait(JobCounter& counter);
+
+    //calls fn(batch, begin, end) for batches of [0, count) split over the workers and the calling thread
+    // - every batch has at least min_batch_size items (unless count is smaller), so small ranges are not worth the overhead of splitting
+    // - batch is in [0, batch_count(count, min_batch_size)) so callers can give each batch its own output
+    // - returns once every batch has finished, rethrowing the first exception thrown
+    template <typename F>
+    void parallel_for(size_t count, size_t min_batch_size, F&& fn);
+
+    [[nodiscard]] size_t batch_count(const size_t count, const size_t min_batch_size) const {
+        return std::clamp<size_t>(count / std::max<size_t>(min_batch_size, 1), 1, no_threads());
+    }
+
+    //the number of threads that run jobs (the workers and the thread that waits)
+    [[nodiscard]] unsigned no_threads() const {return static_cast<unsigned>(queues.size());}
+
+private:
+    struct Job {
+        std::function<void()> work;
+        JobCounter* counter;
+    };
+
+    //a queue of jobs, aligned so the queues of different workers are not on the same cache line
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;     //one per worker, then the shared queue for every other thread
+    [[nodiscard]] unsigned shared_queue() const {return static_cast<unsigned>(queues.size()) - 1;}
+
+    //sleeping when there is nothing to do
+    // - queued is the number of jobs in every queue, it is checked before sleeping so no wake up is missed
+    // - pushes counts every job ever queued, so a waiting thread can tell if anything was queued since it last looked
+    std::atomic<size_t> queued{0};
+    std::atomic<uint64_t> pushes{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;           //workers: a job was queued or stopping
+    std::condition_variable waiter_wake;    //threads in help_until_done: a job was queued or a counter reached 0
+    bool stopping = false;                  //protected by sleep_mutex
+
+    void worker(unsigned index);
+    void push(Job job);
+    //takes a job from this thread's queue or steals one from another
+    bool try_pop(Job& job);
+    //takes a job tracked by `counter' from any queue
+    bool try_pop_for(const JobCounter& counter, Job& job);
+    //runs a job and lets its counter know it has finished
+    void execute(Job& job);
+    void finish(JobCounter& counter, std::exception_ptr error);
+    //running the counter's jobs until it reaches 0, without rethrowing
+    void help_until_done(JobCounter& counter);
+};
+
+
+template <typename F>
+void JobSystem::parallel_for(const size_t count, const size_t min_batch_size, F&& fn) {
+    const size_t no_batches = batch_count(count, min_batch_size);
+    const size_t batch_size = (count + no_batches - 1) / no_batches;
+    const auto run_batch = [&fn, count, batch_size](const size_t batch) {
+        const size_t begin = std::min(batch * batch_size, count);
+        const size_t end = std::min(begin + batch_size, count);
+        fn(batch, begin, end);
+    };
+    if (no_batches == 1) {
+        run_batch(0);
+        return;
+    }
+
+    //the calling thread does the first batch itself rather than sitting idle
+    // - the other batches reference fn so they must finish before returning, even if the first batch throws
+    JobCounter counter;
+    for (size_t batch = 1; batch < no_batches; batch++) {
+        run([&run_batch, batch] {run_batch(batch);}, counter);
+    }
+    try {
+        run_batch(0);
+    } catch (...) {
+        help_until_done(counter);
+        throw;
+    }
+    wait(counter);
+}
+
+
+#endif //VULKAN_ENGINE_JOB_SYSTEM_HPP
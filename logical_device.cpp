@@ -6,6 +6,7 @@
 #include "queue_family.hpp"
 #include <stdexcept>
 #include <set>
+#include <vector>
 
 void LogicalDevice::setup() {
     float queue_priority = 1.0f; //the priority of queues to influence scheduling (not really needed since we only have 1 queue)
@@ -30,14 +31,65 @@ void LogicalDevice::setup() {
     }
 
 
+    //the extensions to enable
+    // - the required ones as well as the optional ones that are supported
+    const auto required_extensions = physical_device.required_extensions();
+    std::vector<const char*> extensions(required_extensions.begin(), required_extensions.end());
+
+    //extended dynamic state needs the extension and its feature enabled if it isn't core
+    const auto extended_dynamic_state_support = ExtendedDynamicState::query_support(physical_device.get_device());
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extended_dynamic_state_features{};     //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkPhysicalDeviceExtendedDynamicStateFeaturesEXT.html
+    extended_dynamic_state_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+    extended_dynamic_state_features.extendedDynamicState = VK_TRUE;
+    if (extended_dynamic_state_support == ExtendedDynamicState::Support::extension) {
+        extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+    }
+
+
+    //timeline semaphores are core in 1.2 but still need to be enabled
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(physical_device.get_device(), &device_properties);
+    VkPhysicalDeviceVulkan12Features vulkan12_features{};   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkPhysicalDeviceVulkan12Features.html
+    vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    if (device_properties.apiVersion >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &vulkan12_features;
+        vkGetPhysicalDeviceFeatures2(physical_device.get_device(), &features);
+    }
+    timeline_semaphores = vulkan12_features.timelineSemaphore == VK_TRUE;
+    //only enabling the features that are used
+    vulkan12_features = {};
+    vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12_features.timelineSemaphore = timeline_semaphores ? VK_TRUE : VK_FALSE;
+
+
+    //pipeline statistics are only used for profiling, so the device is still usable without them
+    VkPhysicalDeviceFeatures supported_features;
+    vkGetPhysicalDeviceFeatures(physical_device.get_device(), &supported_features);
+    pipeline_statistics = supported_features.pipelineStatisticsQuery == VK_TRUE;
+    required_device_features.pipelineStatisticsQuery = pipeline_statistics ? VK_TRUE : VK_FALSE;
+
+
     //actually creating the logical device
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;    //sType must be VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO
     createInfo.pQueueCreateInfos = queueCreateInfo.data();  //array describing the queues that are to be created
     createInfo.queueCreateInfoCount = queueCreateInfo.size();    //the size of the pQueueCreateInfos array
     createInfo.pEnabledFeatures = &required_device_features;    //contains all of the features to be enabled -- array defined in main struct
-    createInfo.enabledExtensionCount = PhysicalDevice::deviceExtensions.size();   //the number of device extensions to enable
-    createInfo.ppEnabledExtensionNames = PhysicalDevice::deviceExtensions.data(); //the names of the extensions to enable -- https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkPhysicalDeviceFeatures.html
+    createInfo.enabledExtensionCount = extensions.size();   //the number of device extensions to enable
+    createInfo.ppEnabledExtensionNames = extensions.data(); //the names of the extensions to enable -- https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkPhysicalDeviceFeatures.html
+    //features not in VkPhysicalDeviceFeatures are enabled by chaining their feature struct
+    void* features_chain = nullptr;
+    if (extended_dynamic_state_support == ExtendedDynamicState::Support::extension) {
+        extended_dynamic_state_features.pNext = features_chain;
+        features_chain = &extended_dynamic_state_features;
+    }
+    if (timeline_semaphores) {
+        vulkan12_features.pNext = features_chain;
+        features_chain = &vulkan12_features;
+    }
+    createInfo.pNext = features_chain;
 
 
     //actually create the logical device
@@ -50,6 +102,9 @@ void LogicalDevice::setup() {
     vkGetDeviceQueue(device, queue_family.graphicsFamily.value(), 0, &graphics_queue);
     vkGetDeviceQueue(device, queue_family.presentFamily.value(), 0, &present_queue);
 
+    //getting the functions to set the dynamic states
+    extended_dynamic_state.load(device, extended_dynamic_state_support);
+
 }
 
 void LogicalDevice::cleanup() const {
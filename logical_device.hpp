@@ -9,6 +9,7 @@
 #include "physical_device.hpp"
 #include <array>
 #include "queue_family.hpp"
+#include "extended_dynamic_state.hpp"
 
 //logical device are used to interface with physical devices
 //this struct also holds the queues that interface with the physical device
@@ -24,6 +25,16 @@ struct LogicalDevice {
     // - This is not device extensions required. This is specified in physical_device.hpp
     VkPhysicalDeviceFeatures required_device_features{};
 
+    //setting the cull mode, depth test, etc when recording command buffers (if the device supports it)
+    ExtendedDynamicState extended_dynamic_state;
+
+    //if timeline semaphores can be used (core in vulkan 1.2, see timeline_semaphore.hpp)
+    bool timeline_semaphores = false;
+
+    //if pipeline statistics queries can be used (see pipeline_statistics.hpp)
+    // - an optional feature, so it is only enabled if the device supports it
+    bool pipeline_statistics = false;
+
     explicit LogicalDevice(PhysicalDevice & pd, QueueFamily &q) : physical_device(pd), queue_family(q) {required_device_features.samplerAnisotropy = true;}
     [[nodiscard]] VkDevice get_device() const {return device;}
 
@@ -1,12 +1,143 @@
 #include "renderer.hpp"
+#include "spsc_queue.hpp"
 
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define EXIT_FALURE 1
 #define EXIT_SUCCESS 0
 
-int main() {
+//how many frames the main thread can make ahead of the render thread
+// - more lets the main thread run further ahead but adds latency
+constexpr size_t frame_packet_queue_size = 2;
+
+//how long the parts of the last few seconds of frames took (see PROFILE_SCOPE)
+static void print_cpu_scope_stats(const Renderer& app) {
+    const auto stats = app.cpu_scope_stats();
+    if (stats.empty()) {
+        return;     //profiling was compiled out
+    }
+    std::cout << "cpu scope                  p50 (us)   p99 (us)   max (us)   samples\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& s : stats) {
+        std::cout << std::left << std::setw(24) << s.name << std::right
+                  << std::setw(11) << static_cast<double>(s.p50) / 1e3
+                  << std::setw(11) << static_cast<double>(s.p99) / 1e3
+                  << std::setw(11) << static_cast<double>(s.max) / 1e3
+                  << std::setw(10) << s.samples << "\n";
+    }
+}
+
+//what the newest finished frame drew
+static void print_frame_stats(Renderer& app) {
+    const auto stats = app.get_frame_stats();
+    if (stats.frame == 0) {
+        return;
+    }
+    std::cout << "frame " << stats.frame << ": " << stats.counters.draw_calls << " draw calls, " << stats.counters.pipeline_binds << " pipeline binds, "
+              << stats.counters.descriptor_binds << " descriptor binds, " << stats.counters.triangles << " triangles\n";
+    for (const auto& pass : stats.passes) {
+        std::cout << "  " << pass.name << ": " << pass.vertex_invocations << " vertex invocations, " << pass.clipping_invocations << " primitives reaching clipping, "
+                  << pass.clipping_primitives << " primitives after clipping, " << pass.fragment_invocations << " fragment invocations\n";
+    }
+}
+
+//rendering a number of frames without a window (e.g. for benchmarks or on a server)
+// - the last frame can be saved as a ppm image
+static int run_headless(const unsigned no_frames, const char* image_file) {
+    Window window;
+    Renderer app(window);
+
+    //the last frame read back, converted to rgb
+    std::vector<unsigned char> image;
+    VkExtent2D image_extent{};
+
+    try {
+        window.makeHeadless(window.window_width, window.window_height);
+        if (image_file != nullptr) {
+            app.set_frame_readback([&](const uint64_t frame, const void* pixels, const VkExtent2D extent) {
+                if (frame < no_frames) {
+                    return;     //only the last frame is kept
+                }
+                //the images are bgra
+                const auto bgra = static_cast<const unsigned char*>(pixels);
+                const size_t no_pixels = static_cast<size_t>(extent.width) * extent.height;
+                image.resize(no_pixels * 3);
+                for (size_t i = 0; i < no_pixels; i++) {
+                    image[3 * i + 0] = bgra[4 * i + 2];
+                    image[3 * i + 1] = bgra[4 * i + 1];
+                    image[3 * i + 2] = bgra[4 * i + 0];
+                }
+                image_extent = extent;
+            });
+        }
+        app.initVulkan();
+    } catch (const std::exception& e) {
+        std::cerr << "Initiating headless vulkan failed\n";
+        std::cerr << e.what() << "\n";
+        return EXIT_FALURE;
+    }
+
+    try {
+        //nothing is waiting on events so the frames are just made and drawn in turn
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < no_frames; i++) {
+            app.drawFrame(app.simulate());
+        }
+        app.endDrawFrame();
+        const auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "rendered " << no_frames << " frames in " << time << "ms\n";
+        print_cpu_scope_stats(app);
+        print_frame_stats(app);
+    } catch (const std::exception& e) {
+        std::cerr << "Headless rendering failed\n";
+        std::cerr << e.what() << "\n";
+        return EXIT_FALURE;
+    }
+
+    try {
+        app.cleanup();  //the last frames readback happens here at the latest
+        window.cleanup();
+    } catch (const std::exception& e) {
+        std::cerr << "Vulkan cleanup failed\n";
+        std::cerr << e.what() << "\n";
+        return EXIT_FALURE;
+    }
+
+    if (image_file != nullptr) {
+        std::ofstream file(image_file, std::ios::binary);
+        file << "P6\n" << image_extent.width << " " << image_extent.height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!file) {
+            std::cerr << "failed to write " << image_file << "\n";
+            return EXIT_FALURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+//usage
+// - Vulkan_engine                                      opens a window
+// - Vulkan_engine --headless <frames> [image.ppm]      renders without a window, optionally saving the last frame
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::strcmp(argv[1], "--headless") == 0) {
+        try {
+            return run_headless(static_cast<unsigned>(std::stoul(argv[2])), argc >= 4 ? argv[3] : nullptr);
+        } catch (const std::logic_error&) {    //std::stoul failing
+            std::cerr << "the number of frames must be a number\n";
+            return EXIT_FALURE;
+        }
+    }
+
     Window window;
     Renderer app(window);
 
@@ -26,14 +157,78 @@ int main() {
         return EXIT_FALURE;
     }
 
+    //the frames made by the main thread waiting to be drawn by the render thread
+    SpscQueue<FramePacket, frame_packet_queue_size> frame_packets;
+
+    //the render thread just draws every frame it is given
+    // - if it fails the queue is closed so the main thread stops too
+    std::exception_ptr render_error;
+    std::thread render_thread([&] {
+        try {
+            FramePacket packet;
+            while (frame_packets.pop(packet)) {
+                app.drawFrame(packet);
+            }
+        } catch (...) {
+            render_error = std::current_exception();
+            frame_packets.close();
+        }
+    });
+
     try {
 
         //having the main loop run units the (x) is pressed
-        while (!glfwWindowShouldClose(window.get_window())) {
+        while (!glfwWindowShouldClose(window.get_window()) && !frame_packets.is_closed()) {
+            //nothing can be drawn while the window is minimised so just waiting for it to come back
+            if (window.minimised()) {
+                glfwWaitEvents();
+                continue;
+            }
             glfwPollEvents();   //checking for events (like (x) being pressed)
-            app.drawFrame();
+
+            //making the next frame while the render thread draws the last one
+            // - waits if the render thread has fallen too far behind
+            auto packet = app.simulate();
+            frame_packets.push(packet);
+
+            //reporting what was clicked on
+            if (window.mouse_clicked) {
+                window.mouse_clicked = false;
+                const auto picked = app.pick(window.click_x, window.click_y);
+                if (picked) {
+                    std::cout << "picked object " << *picked << "\n";
+                }
+            }
+
+            //cycling through the present policies (e.g. to turn vsync off)
+            if (window.present_policy_key) {
+                window.present_policy_key = false;
+                auto settings = app.get_present_settings();
+                settings.policy = next_present_policy(settings.policy);
+                app.set_present_settings(settings);
+                std::cout << "present policy: " << present_policy_name(settings.policy) << "\n";
+            }
+        }
+    } catch (const std::exception& e) {
+        frame_packets.close();
+        render_thread.join();
+        std::cerr << "Main loop failed\n";
+        std::cerr << e.what() << "\n";
+        return EXIT_FALURE;
+    }
+
+    //stopping the render thread
+    // - any frames still in the queue are dropped
+    frame_packets.close();
+    render_thread.join();
+
+    try {
+        if (render_error) {
+            std::rethrow_exception(render_error);
         }
         app.endDrawFrame();
+        print_cpu_scope_stats(app);
+        print_frame_stats(app);
 
     }catch (const std::exception& e) {
         std::cerr << "Vulkan mainloop failed\n";
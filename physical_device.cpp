@@ -91,8 +91,9 @@ bool PhysicalDevice::isDeviceSuitable(VkPhysicalDevice device) {
     const auto extensions_supported = checkDeviceExtensionSupport(device);
 
     //checking if there is an available swapchain to use
-    bool swap_chain_good = false;
-    if (extensions_supported) {
+    // - headless rendering doesn't use a swapchain
+    bool swap_chain_good = surface.headless();
+    if (extensions_supported && !surface.headless()) {
         SwapChainDetails swap_chain_details;
         swap_chain_details.query_swap_chain_support(device, surface.get_surface());
         swap_chain_good = true;
@@ -107,7 +108,14 @@ bool PhysicalDevice::isDeviceSuitable(VkPhysicalDevice device) {
     return extensions_supported && queue_family_good && swap_chain_good && anisotropy_good;
 }
 
-bool PhysicalDevice::checkDeviceExtensionSupport(VkPhysicalDevice device) {
+std::span<const char* const> PhysicalDevice::required_extensions() const {
+    if (surface.headless()) {
+        return {};
+    }
+    return deviceExtensions;
+}
+
+bool PhysicalDevice::checkDeviceExtensionSupport(VkPhysicalDevice device) const {
     //finding all the extensions supported
     uint32_t extensionCount;    //the number of extensions supported
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);    //querying the number of supported extensions
@@ -116,7 +124,8 @@ bool PhysicalDevice::checkDeviceExtensionSupport(VkPhysicalDevice device) {
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data()); //querying the supported extensions
 
     //checking to make sure add required extensions are supported
-    std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end()); //create a copy of the extensions to then removed elements from
+    const auto required = required_extensions();
+    std::set<std::string> requiredExtensions(required.begin(), required.end()); //create a copy of the extensions to then removed elements from
 
     //removing elements from the required extensions until all supported extensions are checked
     for (const auto& ext : availableExtensions) {
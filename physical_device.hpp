@@ -7,6 +7,7 @@
 
 #include "instance.hpp"
 #include "surface.hpp"
+#include <span>
 
 struct PhysicalDevice {
     explicit PhysicalDevice(Instance &i, Surface &s) : instance(i), surface(s) {}
@@ -15,13 +16,15 @@ struct PhysicalDevice {
     //device extensions required
     // - https://www.khronos.org/registry/vulkan/ has a list of extensions
     static constexpr std::array<const char*, 1> deviceExtensions = {"VK_KHR_swapchain"};
+    //the extensions actually needed -- none when headless (there is no swapchain)
+    [[nodiscard]] std::span<const char* const> required_extensions() const;
 
     //check the suitability of the graphics cards
     // - need to check that they meet the requirements for the program
     // - (there are more requirements than those just set in the instance)
     unsigned rateDeviceSuitability(VkPhysicalDevice device);
     bool isDeviceSuitable(VkPhysicalDevice device);
-    static bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+    bool checkDeviceExtensionSupport(VkPhysicalDevice device) const;
     VkPhysicalDevice& get_device() {return physicalDevice;}
 
 
@@ -0,0 +1,105 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "pipeline_cache.hpp"
+#include <cstring>  //for memcpy
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <cstdio>   //for std::rename and std::remove
+#include <iostream>
+
+std::vector<char> PipelineCache::read_cache_file() const {
+    std::ifstream file(cache_location, std::ios::ate | std::ios::binary);  //::ate so get the file size for free
+    if (!file.is_open()) {
+        return {};  //there is no cache yet (e.g. the first run)
+    }
+
+    const auto file_size = static_cast<long>(file.tellg());
+    if (file_size < static_cast<long>(sizeof(VkPipelineCacheHeaderVersionOne))) {
+        return {};
+    }
+    std::vector<char> data(file_size);
+    file.seekg(0);
+    file.read(data.data(), file_size);
+    if (!file) {
+        return {};
+    }
+
+    //checking the header matches the current device
+    // - https://khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkPipelineCacheHeaderVersionOne.html
+    // - the driver is supposed to do this check itself, but not every driver does it properly
+    VkPipelineCacheHeaderVersionOne header{};
+    std::memcpy(&header, data.data(), sizeof(header));  //the file data isn't necessarily aligned so copying it out
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(device.physical_device.get_device(), &properties);
+
+    if (header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+        std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return {};  //the cache was made by a different card or driver version
+    }
+
+    return data;
+}
+
+void PipelineCache::setup() {
+    const auto initial_data = read_cache_file();
+    loaded = !initial_data.empty();
+
+    VkPipelineCacheCreateInfo createInfo{};     //https://khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkPipelineCacheCreateInfo.html
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;    //sType must be VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO
+    createInfo.flags = 0;                                               //0 keeps the cache internally synchronised, so several compile jobs can call vkCreateGraphicsPipelines with it at once
+                                                                        // - VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT would make that unsafe
+    createInfo.initialDataSize = initial_data.size();                   //the size of the data from the previous run (0 for an empty cache)
+    createInfo.pInitialData = initial_data.empty() ? nullptr : initial_data.data();
+
+    if (vkCreatePipelineCache(device.get_device(), &createInfo, nullptr, &pipeline_cache) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+}
+
+void PipelineCache::save() const {
+    //the cache only makes starting up faster, so failing to save it is reported rather than thrown
+    // - save is called part way through cleanup, and throwing would leave everything after it not destroyed
+    //getting the size of the data and then the data itself
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(device.get_device(), pipeline_cache, &data_size, nullptr) != VK_SUCCESS) {
+        std::cerr << "failed to get pipeline cache size!\n";
+        return;
+    }
+    std::vector<char> data(data_size);
+    if (vkGetPipelineCacheData(device.get_device(), pipeline_cache, &data_size, data.data()) != VK_SUCCESS) {
+        std::cerr << "failed to get pipeline cache data!\n";
+        return;
+    }
+
+    //writing to a temporary file and then moving it over the old cache
+    // - if the program crashes while writing, the old cache is still there and valid
+    const auto& location = cache_location;
+    const auto temp_location = location + ".tmp";
+    {
+        std::ofstream file(temp_location, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "failed to open pipeline cache file for writing: " << temp_location << "\n";
+            return;
+        }
+        file.write(data.data(), static_cast<long>(data_size));
+        if (!file) {
+            file.close();
+            std::remove(temp_location.c_str());
+            std::cerr << "failed to write pipeline cache: " << temp_location << "\n";
+            return;
+        }
+    }
+    if (std::rename(temp_location.c_str(), location.c_str()) != 0) {
+        std::remove(temp_location.c_str());
+        std::cerr << "failed to replace the pipeline cache file: " << location << "\n";
+    }
+}
+
+void PipelineCache::cleanup() {
+    vkDestroyPipelineCache(device.get_device(), pipeline_cache, nullptr);
+}
@@ -0,0 +1,44 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_PIPELINE_CACHE_HPP
+#define VULKAN_ENGINE_PIPELINE_CACHE_HPP
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "logical_device.hpp"
+
+//cache of compiled pipelines that is kept between runs of the program
+// - passed to every vkCreateGraphicsPipelines so the driver can skip compiling pipelines it has seen before
+// - loaded from disk in setup and written back to disk in save
+// - the data on disk is only used if its header matches the current driver and graphics card
+//   > data from a different card/driver is ignored (the driver would either reject it or, worse, misbehave)
+struct PipelineCache {
+    VkPipelineCache pipeline_cache{};
+
+    PipelineCache(LogicalDevice &d, const std::string_view cache_file_location) : cache_location(cache_file_location), device(d) {}
+
+    void setup();
+    void save() const;  //must be called before cleanup, failures are printed rather than thrown (the cache is only an optimisation)
+    void cleanup();
+
+    [[nodiscard]] VkPipelineCache& get_pipeline_cache() {return pipeline_cache;}
+
+    //if valid data was loaded from disk (i.e. pipelines should be quick to create)
+    [[nodiscard]] bool loaded_from_disk() const {return loaded;}
+
+    const std::string cache_location;   //a copy (not a view) so it is null terminated for the file streams
+
+private:
+    LogicalDevice &device;
+    bool loaded = false;
+
+    //reads the cache file, returning nothing if it doesn't exist or is for a different device
+    [[nodiscard]] std::vector<char> read_cache_file() const;
+};
+
+
+#endif //VULKAN_ENGINE_PIPELINE_CACHE_HPP
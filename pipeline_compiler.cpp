@@ -0,0 +1,44 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "pipeline_compiler.hpp"
+
+#include <exception>
+
+PipelineCompiler::~PipelineCompiler() {
+    //the counters must outlive the jobs that use them
+    // - any errors have already been reported to whoever called wait, or nobody is left to report them to
+    try {
+        wait_all();
+    } catch (...) {}
+}
+
+void PipelineCompiler::add(std::function<void()> compile, const bool needed_for_first_frame) {
+    if (needed_for_first_frame) {
+        jobs.run(std::move(compile), first_frame);
+    } else {
+        jobs.run_after(first_frame, std::move(compile), &later);
+    }
+}
+
+void PipelineCompiler::wait_first_frame() {
+    jobs.wait(first_frame);
+}
+
+void PipelineCompiler::wait_all() {
+    //waiting on both counters even if the first throws, so nothing is still running when this returns
+    std::exception_ptr error;
+    for (auto* counter : {&first_frame, &later}) {
+        try {
+            jobs.wait(*counter);
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,44 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_PIPELINE_COMPILER_HPP
+#define VULKAN_ENGINE_PIPELINE_COMPILER_HPP
+
+#include <functional>
+#include "job_system.hpp"
+
+//compiles graphics pipelines on the workers of a JobSystem
+// - pipeline creation is by far the slowest part of startup, and every pipeline can be created independently
+// - all the pipelines share the same PipelineCache (vulkan pipeline caches are internally synchronised unless told otherwise)
+// - jobs needed for the first frame are run before any others, so the renderer can start drawing while the rest are still compiling
+// - the thread that waits also compiles pipelines rather than sitting idle
+struct PipelineCompiler {
+    explicit PipelineCompiler(JobSystem& j) : jobs(j) {}
+    ~PipelineCompiler();
+
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    //queues a pipeline to be created
+    // - compile is usually just a call to GraphicsPipeline::setup
+    // - jobs not needed for the first frame are only started once every first frame job queued so far has finished
+    void add(std::function<void()> compile, bool needed_for_first_frame = true);
+
+    //blocks until every job needed for the first frame has finished
+    // - rethrows the first exception thrown by any of them
+    void wait_first_frame();
+
+    //blocks until every job has finished
+    // - rethrows the first exception thrown by any job
+    // - must be called before destroying anything the jobs use
+    void wait_all();
+
+private:
+    JobSystem& jobs;
+    JobCounter first_frame;     //the jobs needed for the first frame
+    JobCounter later;           //every other job
+};
+
+
+#endif //VULKAN_ENGINE_PIPELINE_COMPILER_HPP
@@ -0,0 +1,107 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "pipeline_statistics.hpp"
+#include <array>
+#include <stdexcept>
+
+void PipelineStatistics::setup(const unsigned no_frames, const bool enable) {
+    if (!enable || !device.pipeline_statistics) {
+        return;
+    }
+
+    frames.resize(no_frames);
+    for (auto& frame : frames) {
+        VkQueryPoolCreateInfo poolInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkQueryPoolCreateInfo.html
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;  //sType must be VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO
+        poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        poolInfo.queryCount = max_passes;
+        poolInfo.pipelineStatistics = counted;                      //the statistics every query in the pool counts
+        if (vkCreateQueryPool(device.get_device(), &poolInfo, nullptr, &frame.pool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline statistics query pool");
+        }
+        frame.passes.reserve(max_passes);
+    }
+}
+
+void PipelineStatistics::cleanup() {
+    for (auto& frame : frames) {
+        vkDestroyQueryPool(device.get_device(), frame.pool, nullptr);
+    }
+    frames.clear();
+}
+
+void PipelineStatistics::begin_frame(VkCommandBuffer command_buffer, const unsigned frame) {
+    if (!enabled()) {
+        return;
+    }
+    recording = frame;
+    auto& f = frames[frame];
+    f.passes.clear();
+    f.pending = false;
+    //queries must be reset before they are begun again
+    vkCmdResetQueryPool(command_buffer, f.pool, 0, max_passes);
+}
+
+uint32_t PipelineStatistics::begin_pass(VkCommandBuffer command_buffer, const char* name) {
+    if (!enabled()) {
+        return UINT32_MAX;
+    }
+    auto& f = frames[recording];
+    if (f.passes.size() == max_passes) {
+        return UINT32_MAX;
+    }
+    const auto pass = static_cast<uint32_t>(f.passes.size());
+    //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/vkCmdBeginQuery.html
+    // - no flags, VK_QUERY_CONTROL_PRECISE_BIT is only for occlusion queries
+    vkCmdBeginQuery(command_buffer, f.pool, pass, 0);
+    f.passes.push_back({name});
+    return pass;
+}
+
+void PipelineStatistics::end_pass(VkCommandBuffer command_buffer, const uint32_t pass) {
+    if (!enabled() || pass == UINT32_MAX) {
+        return;
+    }
+    auto& f = frames[recording];
+    vkCmdEndQuery(command_buffer, f.pool, pass);
+    f.passes[pass].ended = true;
+}
+
+void PipelineStatistics::submitted() {
+    if (!enabled()) {
+        return;
+    }
+    frames[recording].pending = true;
+}
+
+void PipelineStatistics::collect(const unsigned frame, std::vector<PassStatistics>& passes) {
+    passes.clear();
+    if (!enabled() || !frames[frame].pending) {
+        return;
+    }
+    auto& f = frames[frame];
+    f.pending = false;
+    if (f.passes.empty()) {
+        return;
+    }
+
+    //the frame is finished so this doesn't wait
+    // - each query gives a value for every statistic counted and then if it is available
+    constexpr uint32_t stride = no_counted + 1;
+    std::array<uint64_t, max_passes * stride> results{};
+    const auto result = vkGetQueryPoolResults(device.get_device(), f.pool, 0, static_cast<uint32_t>(f.passes.size()), sizeof(results), results.data(), stride * sizeof(uint64_t),
+                                              VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        throw std::runtime_error("failed to read pipeline statistics queries");
+    }
+
+    for (size_t i = 0; i < f.passes.size(); i++) {
+        const auto values = &results[i * stride];
+        if (!f.passes[i].ended || values[no_counted] == 0) {
+            continue;
+        }
+        passes.push_back({f.passes[i].name, values[0], values[1], values[2], values[3]});
+    }
+}
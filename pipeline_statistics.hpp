@@ -0,0 +1,71 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_PIPELINE_STATISTICS_HPP
+#define VULKAN_ENGINE_PIPELINE_STATISTICS_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+#include "logical_device.hpp"
+#include "frame_stats.hpp"
+
+//counting what the GPU does in each pass of a frame with pipeline statistics queries
+// - a query pool for every frame in flight, read once the frame using it is known to be finished (same as GpuProfiler)
+// - needs the pipelineStatisticsQuery feature, and does nothing unless asked for because the queries aren't free on every GPU
+// - only one pass can be counted at a time (queries of the same type can't be nested)
+// - https://www.khronos.org/registry/vulkan/specs/1.3-extensions/html/vkspec.html#queries-pipestats
+struct PipelineStatistics {
+    explicit PipelineStatistics(LogicalDevice &d) : device(d) {}
+
+    //creating the query pools if the device supports them and `enable' is set
+    void setup(unsigned no_frames, bool enable);
+    void cleanup();
+
+    [[nodiscard]] bool enabled() const {return !frames.empty();}
+
+    //starting a frame -- must be called before any passes while recording its command buffer (outside a render pass)
+    // - the last frame that used `frame' must have been collected
+    void begin_frame(VkCommandBuffer command_buffer, unsigned frame);
+
+    //counting part of the frame
+    // - name must live for the whole program (i.e. a string literal)
+    // - a pass begun inside a render pass must end inside the same subpass
+    // - passes are dropped if there are too many in a frame
+    [[nodiscard]] uint32_t begin_pass(VkCommandBuffer command_buffer, const char* name);
+    void end_pass(VkCommandBuffer command_buffer, uint32_t pass);
+
+    //the frame recorded last was submitted
+    void submitted();
+
+    //the counts of the last frame that used `frame'
+    // - the frame must have finished on the GPU (e.g. its fence was waited on)
+    // - passes is left empty if there is nothing to collect
+    void collect(unsigned frame, std::vector<PassStatistics>& passes);
+
+    static constexpr uint32_t max_passes = 16;     //per frame
+
+    //what is counted, the results come back in the order of the bits
+    static constexpr VkQueryPipelineStatisticFlags counted = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+                                                             VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+    static constexpr uint32_t no_counted = 4;
+
+private:
+    struct Pass {
+        const char* name;
+        bool ended = false;
+    };
+    struct Frame {
+        VkQueryPool pool = VK_NULL_HANDLE;
+        std::vector<Pass> passes;
+        bool pending = false;   //submitted and not collected yet
+    };
+    std::vector<Frame> frames;
+    unsigned recording = 0;     //the frame being recorded
+
+    LogicalDevice &device;
+};
+
+
+#endif //VULKAN_ENGINE_PIPELINE_STATISTICS_HPP
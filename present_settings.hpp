@@ -0,0 +1,73 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_PRESENT_SETTINGS_HPP
+#define VULKAN_ENGINE_PRESENT_SETTINGS_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+//how images are given to the screen
+// - each policy has a list of present modes to try in order, falling back to FIFO (the only mode that is always available)
+// - see swap_chain_details.hpp for what each present mode does
+enum class PresentPolicy : uint8_t {
+    vsync,          //FIFO -- never tears, capped to the refresh rate
+    adaptive_vsync, //FIFO_RELAXED -- like vsync but tears instead of waiting a whole refresh when a frame is late
+    low_latency,    //MAILBOX -- never tears, renders as fast as possible with the newest image shown at each refresh
+    uncapped        //IMMEDIATE -- renders as fast as possible and shows images right away (tears), for benchmarking
+};
+
+constexpr PresentPolicy next_present_policy(const PresentPolicy policy) {
+    switch (policy) {
+        case PresentPolicy::vsync:          return PresentPolicy::adaptive_vsync;
+        case PresentPolicy::adaptive_vsync: return PresentPolicy::low_latency;
+        case PresentPolicy::low_latency:    return PresentPolicy::uncapped;
+        case PresentPolicy::uncapped:       return PresentPolicy::vsync;
+    }
+    return PresentPolicy::vsync;
+}
+
+constexpr std::string_view present_policy_name(const PresentPolicy policy) {
+    switch (policy) {
+        case PresentPolicy::vsync:          return "vsync";
+        case PresentPolicy::adaptive_vsync: return "adaptive vsync";
+        case PresentPolicy::low_latency:    return "low latency";
+        case PresentPolicy::uncapped:       return "uncapped";
+    }
+    return "unknown";
+}
+
+//the present modes to try for each policy (most wanted first)
+namespace PresentModePreferences {
+    inline constexpr VkPresentModeKHR vsync[] = {VK_PRESENT_MODE_FIFO_KHR};
+    inline constexpr VkPresentModeKHR adaptive_vsync[] = {VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR};
+    inline constexpr VkPresentModeKHR low_latency[] = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR};
+    inline constexpr VkPresentModeKHR uncapped[] = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR};
+}
+
+constexpr std::span<const VkPresentModeKHR> present_mode_preferences(const PresentPolicy policy) {
+    switch (policy) {
+        case PresentPolicy::vsync:          return PresentModePreferences::vsync;
+        case PresentPolicy::adaptive_vsync: return PresentModePreferences::adaptive_vsync;
+        case PresentPolicy::low_latency:    return PresentModePreferences::low_latency;
+        case PresentPolicy::uncapped:       return PresentModePreferences::uncapped;
+    }
+    return PresentModePreferences::vsync;
+}
+
+//everything that controls how frames are paced
+// - can be changed while running (see Renderer::set_present_settings)
+struct PresentSettings {
+    PresentPolicy policy = PresentPolicy::vsync;
+    uint32_t image_count = 0;       //the number of images to ask the swapchain for (0 means 1 more than the minimum)
+                                    // - clamped to what the surface supports
+    unsigned frames_in_flight = 2;  //how many frames the CPU can be recording ahead of the GPU (at least 1)
+
+    bool operator==(const PresentSettings&) const = default;
+};
+
+
+#endif //VULKAN_ENGINE_PRESENT_SETTINGS_HPP
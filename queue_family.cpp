@@ -26,7 +26,7 @@ void QueueFamily::setup() {
             }
         }
 
-        if (!found_present) {
+        if (!found_present && surface != VK_NULL_HANDLE) {
             VkBool32 presentSupport = false;
             vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
             if (presentSupport) {
@@ -41,4 +41,10 @@ void QueueFamily::setup() {
 
     }
 
+    //when rendering headless there is no surface and so nothing to present to
+    // - the graphics queue stands in for the present queue so the rest of the program doesn't need to know
+    if (surface == VK_NULL_HANDLE) {
+        presentFamily = graphicsFamily;
+    }
+
 }
\ No newline at end of file
@@ -38,6 +38,9 @@ void RenderPass::setup() {
     //final layout represents the layout of the image after rendering
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;      //we do not care about the format of the image since we are going to be clearing the image
     colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;  //the rendered images go straight to the swapchain
+    if (swap_chain.headless()) {
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;    //nothing is presented, the images may be copied out instead
+    }
 
 
     //specifying the depth attachment
@@ -99,6 +102,18 @@ void RenderPass::setup() {
 
 
 
+    //when headless the image may be copied out after the render pass (see CommandBuffers::record)
+    // - so the copy has to wait for the colour attachment to be written (and the transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+    VkSubpassDependency readback_dependency{};
+    readback_dependency.srcSubpass = 0;
+    readback_dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    readback_dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    readback_dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    readback_dependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    readback_dependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    const std::array<VkSubpassDependency, 2> dependencies = {dependency, readback_dependency};
+
+
     //actually creating the render pass
     std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
     VkRenderPassCreateInfo renderPassInfo{};    //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkRenderPassCreateInfo.html
@@ -107,8 +122,8 @@ void RenderPass::setup() {
     renderPassInfo.pAttachments = attachments.data();     //pointer to an array of VkAttachmentDescription structures
     renderPassInfo.subpassCount = 1;                    //the total number of subpasses (the graphics pipeline uses these subasses)
     renderPassInfo.pSubpasses = &subpass;               //pointer to any array of VkSubpassDependency structures
-    renderPassInfo.dependencyCount = 1;                 //the number of memory dependencies between subpasses
-    renderPassInfo.pDependencies = &dependency;         //the array of memory dependencies
+    renderPassInfo.dependencyCount = swap_chain.headless() ? 2 : 1;    //the number of memory dependencies between subpasses
+    renderPassInfo.pDependencies = dependencies.data();                 //the array of memory dependencies
 
 
     const auto create_pass_res = vkCreateRenderPass(device.get_device(), &renderPassInfo, nullptr, &render_pass);
@@ -121,3 +136,10 @@ void RenderPass::setup() {
 void RenderPass::cleanup() {
     vkDestroyRenderPass(device.get_device(), render_pass, nullptr);
 }
+
+void RenderPass::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    deletion_queue.push(frame, [d = device.get_device(), old_render_pass = render_pass] {
+        vkDestroyRenderPass(d, old_render_pass, nullptr);
+    });
+    render_pass = VK_NULL_HANDLE;
+}
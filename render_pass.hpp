@@ -8,6 +8,7 @@
 #include <vulkan/vulkan.h>
 #include "logical_device.hpp"
 #include "swap_chain.hpp"
+#include "deletion_queue.hpp"
 
 //tells vulkan about the framebuffer attachments that'll be used.
 // - specify the colour and depth bufferss
@@ -18,6 +19,9 @@ struct RenderPass {
 
     void setup();
     void cleanup();
+    //destroying the render pass once `frame' has finished on the GPU
+    // - setup can be called straight away to make a new render pass
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
 
     [[nodiscard]] VkRenderPass& get_render_pass() {return render_pass;}
 
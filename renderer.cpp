@@ -3,20 +3,42 @@
 //
 
 #include "renderer.hpp"
+#include <glm/gtc/matrix_transform.hpp>
 #include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <cstdlib>  //for getenv
+#include <iostream>
+#include <utility>
 
 
 void Renderer::initVulkan() {
+    //timing each part of starting up (see get_startup_timings)
+    startup_timings.start();
+
+    //recording the timings of the frames if asked to
+    if (const char* trace_file = std::getenv(trace_variable)) {
+        trace.start(trace_file);
+    }
+
+    //decoding the textures on the job system while the device is set up
+    // - decoding doesn't need vulkan, and is one of the slower parts of starting up
+    jobs.run([this] {texture.load();}, texture_decoding);
+    jobs.run([this] {texture2.load();}, texture_decoding);
+
     //instance must be created first because this describes all the features from vulkan that we need
-    instance.create();
+    // - the window decides if there is anything to present to
+    instance.create(window.headless);
 #ifdef VALDIATION_LAYERS
     //setting up the debug messenger requires the instance to be set correct
     // - need to specify additional vulkan features to use the custom messenger.
     debug_messenger.setup();
 #endif
+    startup_timings.end_phase("instance");
 
     //setting up the surface to render to
     surface.setup();
+    startup_timings.end_phase("surface");
 
     //selecting the graphics card that
     // 1. supports the features we need
@@ -29,24 +51,56 @@ void Renderer::initVulkan() {
 
     //setting up the interface to the physical device
     logical_device.setup();
+    startup_timings.end_phase("device");
 
 
     //setting up the framebuffers
+    // - using the present settings given before starting
+    apply_pending_present_settings();
     swap_chain.setup();
 
     //creating views into the swapchain images
     image_views.setup();
+    startup_timings.end_phase("swap chain");
+
+    //starting to compile the graphics pipelines
+    // - this is the slowest part of starting up, so it is done on other threads while everything else is being created
+    //=========================================
+    //creating the layout for passing data to the shaders
+    // - must be done before pipeline is created
+    descriptor_set_layout.setup();
+    descriptor_set_layout2.setup();
+    camera_set_layout.setup();
+
+    //creating the render pass -- must be done before creating the graphics pipeline
+    render_pass.setup();
+
+    //loading the pipelines compiled in previous runs
+    // - must be done before creating the graphics pipeline
+    pipeline_cache.setup();
+
+    //queuing the graphics pipelines to be compiled
+    // - everything they use has been created above and is not touched until they are done
+    pipeline_compiler.add([this] {graphics_pipeline3.setup();});
+    pipeline_compiler.add([this] {graphics_pipeline2.setup();});
+    pipeline_compiler.add([this] {graphics_pipeline1.setup();});
+    startup_timings.pipeline_cache_hit = pipeline_cache.loaded_from_disk();
+    startup_timings.end_phase("pipeline setup");
 
     //setting up the uniform buffer object
     // - must be created before the descriptor set
     uniform_buffer_object.setup();
     uniform_buffer_object2.setup();
     uniform_buffer_object3.setup();
+    camera_buffer.setup();
 
     //creating command pools
     command_pool.setup();
+    startup_timings.end_phase("uniform buffers");
 
     //creating the texture
+    // - rethrows if either failed to decode
+    jobs.wait(texture_decoding);
     texture.setup();
     texture2.setup();
 
@@ -56,28 +110,18 @@ void Renderer::initVulkan() {
 
     //creating how the shader accesses images (this is independent of any specific texture)
     texture_sampler.setup(VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
-
-    //creating the layout for passing data to the shaders
-    // - must be done before pipeline is created
-    descriptor_set_layout.setup();
-    descriptor_set_layout2.setup();
+    startup_timings.end_phase("textures");
 
     //creating the descriptor pool
     descriptor_pool.setup();
     descriptor_pool2.setup();
 
     //creating the descriptor sets
+    camera_descriptor_set.setup();
     descriptor_set.setup();
     descriptor_set2.setup();
     descriptor_set3.setup();
-
-    //creating the render pass -- must be done before creating the graphics pipeline
-    render_pass.setup();
-
-    //creating the graphics pipeline
-    graphics_pipeline3.setup();
-    graphics_pipeline2.setup();
-    graphics_pipeline1.setup();
+    startup_timings.end_phase("descriptors");
 
     //creating the depth image
     depth_image.setup();
@@ -85,6 +129,13 @@ void Renderer::initVulkan() {
     //creating the framebufers
     framebuffers.setup();
 
+    //creating the buffers to read the frames back into
+    // - there is nothing to read back when presenting
+    if (swap_chain.headless()) {
+        frame_readback.setup(max_frames_in_flight());
+    }
+    startup_timings.end_phase("framebuffers");
+
 
     //creating and filling the vertex buffer
     // - must be done before command buffers are created
@@ -95,24 +146,96 @@ void Renderer::initVulkan() {
     //creating the index buffers
     // - must be done before command buffers are created
     index_buffer_square.setup();
-
-    //creating and recording the drawing commands
-    command_buffers.setup();
+    startup_timings.end_phase("vertex buffers");
+
+    //creating the command buffers
+    // - the drawing commands are recorded every frame in drawFrame
+    command_buffers.setup(max_frames_in_flight());
+    gpu_profiler.setup(max_frames_in_flight());     //only does anything when tracing
+    pipeline_statistics.setup(max_frames_in_flight(), std::getenv(pipeline_statistics_variable) != nullptr);
+    in_flight_stats.assign(max_frames_in_flight(), {});
+    startup_timings.end_phase("command buffers");
+
+    //each object is rotating about a different axis at 90 degrees a second
+    transforms.clear();
+    transforms.reserve(CulledObjects::no_objects);
+    transforms.add(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::radians(90.0f));    //square
+    transforms.add(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::radians(90.0f));    //textured_square1
+    transforms.add(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::radians(90.0f));    //textured_square2
+
+    //the bounds used for frustum culling and picking
+    // - built where the objects start, then moved with them every frame in simulate
+    object_bounds.fill(square_bounds);
+    std::array<glm::mat4, CulledObjects::no_objects> start_models{};
+    transform_updater.update(transforms, 0.0, glm::mat4(1.0f), start_models.data());
+    std::vector<AABB> start_bounds(CulledObjects::no_objects);
+    for (uint32_t i = 0; i < CulledObjects::no_objects; i++) {
+        start_bounds[i] = object_bounds[i].transformed(start_models[i]);
+    }
+    scene.build(start_bounds);
+    startup_timings.end_phase("scene");
 
     //creating semaphores
-    semaphores.setup();
+    semaphores.setup(max_frames_in_flight());
+
+    //creating the frame synchronisation
+    // - a single timeline semaphore if supported, otherwise a fence for every frame in flight
+    use_timeline_semaphores = logical_device.timeline_semaphores && std::getenv(binary_sync_variable) == nullptr;
+    if (use_timeline_semaphores) {
+        frame_timeline.setup();
+        image_values.assign(swap_chain.swapChainImages.size(), 0);
+    } else {
+        fences.setup(max_frames_in_flight());
+
+        //want to be able to set that any image in the swapchain is in flight
+        imagesInFlight.resize(swap_chain.swapChainImages.size(),VK_NULL_HANDLE);
+    }
+    frame_values.assign(max_frames_in_flight(), 0);
+    startup_timings.end_phase("frame sync");
+
+    //only the pipelines used in the first frame need to be finished before drawing can start
+    // - this thread helps compile them rather than just waiting
+    pipeline_compiler.wait_first_frame();
+    startup_timings.end_phase("pipelines");
+
+    //the objects start rotating once everything is ready
+    start_time = std::chrono::steady_clock::now();
+}
 
-    //creating the fences
-    fences.setup();
 
-    //want to be able to set that any image in the swapchain is in flight
-    imagesInFlight.resize(swap_chain.swapChainImages.size(),VK_NULL_HANDLE);
+Renderer::~Renderer() {
+    //the jobs use members declared after the job system (the textures, pipelines, render pass and the counters), which are destroyed before it
+    // - so they must finish before any member is destroyed
+    // - only matters if initVulkan threw part way through, otherwise initVulkan and cleanup have already waited for them
+    // - any error has already been thrown from initVulkan or reported by cleanup
+    try {
+        jobs.wait(texture_decoding);
+    } catch (...) {}
+    try {
+        pipeline_compiler.wait_all();
+    } catch (...) {}
 }
 
 
 void Renderer::cleanup() {
-    //destroying the fences
-    fences.cleanup();
+    //pipelines that are not used straight away may still be compiling
+    // - a pipeline that failed to compile is reported rather than thrown, so everything else is still destroyed
+    try {
+        pipeline_compiler.wait_all();
+    } catch (const std::exception& e) {
+        std::cerr << "failed to compile a graphics pipeline: " << e.what() << "\n";
+    }
+
+    //destroying everything that was waiting for its frames to finish
+    // - the device is idle (see endDrawFrame)
+    deletion_queue.flush();
+
+    //destroying the fences or timeline semaphore
+    if (use_timeline_semaphores) {
+        frame_timeline.cleanup();
+    } else {
+        fences.cleanup();
+    }
 
     //destroying semaphores
     semaphores.cleanup();
@@ -121,6 +244,7 @@ void Renderer::cleanup() {
     uniform_buffer_object.cleanup();
     uniform_buffer_object2.cleanup();
     uniform_buffer_object3.cleanup();
+    camera_buffer.cleanup();
 
     //destroying the descriptor pools
     descriptor_pool.cleanup();
@@ -129,6 +253,7 @@ void Renderer::cleanup() {
     //destroying the descriptor set layout
     descriptor_set_layout.cleanup();
     descriptor_set_layout2.cleanup();
+    camera_set_layout.cleanup();
 
     //destroying the index buffers
     index_buffer_square.cleanup();
@@ -149,12 +274,24 @@ void Renderer::cleanup() {
     texture.cleanup();
     texture2.cleanup();
 
+    //destroying the command buffers
+    command_buffers.cleanup();
+
+    //destroying the timestamp queries (the last frames timings are added to the trace first)
+    gpu_profiler.cleanup();
+
+    //destroying the pipeline statistics queries
+    pipeline_statistics.cleanup();
+
     //destroying the command pool
     command_pool.cleanup();
 
     //destroying the depth image
     depth_image.cleanup();
 
+    //destroying the buffers the frames are read back into
+    frame_readback.cleanup();
+
     //destroying the framebuffers
     framebuffers.cleanup();
 
@@ -163,6 +300,13 @@ void Renderer::cleanup() {
     graphics_pipeline2.cleanup();
     graphics_pipeline3.cleanup();
 
+    //destroying the shader modules used by the pipelines
+    shader_cache.cleanup();
+
+    //saving the compiled pipelines for next time and destroying the cache
+    pipeline_cache.save();
+    pipeline_cache.cleanup();
+
     //destroying the render pass
     render_pass.cleanup();
 
@@ -186,45 +330,135 @@ void Renderer::cleanup() {
 
     //closing the instance
     instance.cleanup();
+
+    //saving the timings of the frames
+    collect_cpu_scopes();
+    trace.write();
+}
+
+FramePacket Renderer::simulate() {
+    PROFILE_SCOPE("simulate");
+    FramePacket packet;
+    packet.number = ++packets_made;
+
+    //the camera is worked out once here for the shaders, the transforms and culling
+    packet.camera = UBO::make_camera(window_extent());
+
+    //moving every object
+    // - all the model matrices are worked out in one batch straight into the packet (see transform_range)
+    // - the shaders apply the camera themselves so the model-view-projection matrices are not needed
+    const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    transform_updater.update(transforms, time, packet.camera.view_proj, packet.models.data());
+
+    //moving the bounds of every object with it
+    // - refitting only touches the nodes above the objects (the tree is rebuilt if it has got too loose)
+    for (uint32_t i = 0; i < CulledObjects::no_objects; i++) {
+        scene.update(i, object_bounds[i].transformed(packet.models[i]));
+    }
+    scene.refit();
+
+    //culling the objects outside the camera's view
+    // - using the same camera as the shaders
+    const auto frustum = Frustum::from_matrix(packet.camera.view_proj);
+    scene.query(frustum, packet.visible_objects);
+
+    return packet;
 }
 
-void Renderer::drawFrame() {
+void Renderer::drawFrame(const FramePacket& packet) {
+    PROFILE_SCOPE("drawFrame");
+    collect_cpu_scopes();
+
+    //the present settings were changed so the swapchain needs to be recreated to use them
+    // - also trying again if the window was minimised the last time it was recreated
+    if (swap_chain_out_of_date || has_pending_present_settings()) {
+        recreateSwapChain();
+        if (swap_chain_out_of_date) {
+            return;     //still minimised, there is nothing to draw to
+        }
+    }
+
     //synchronsing the CPU and the GPU (so commands don't get submitted to the GPU while the GPU is still rendering the previous frame)
     // - reset fences is also called later
-    vkWaitForFences(logical_device.get_device(), 1, &fences.get_fences()[currentFrame], VK_TRUE, UINT64_MAX);
+    // - with timeline semaphores this is usually just comparing values
+    {
+        PROFILE_SCOPE("wait for frame");
+        if (use_timeline_semaphores) {
+            frame_timeline.wait(frame_values[currentFrame]);
+        } else {
+            vkWaitForFences(logical_device.get_device(), 1, &fences.get_fences()[currentFrame], VK_TRUE, UINT64_MAX);
+        }
+    }
+    //the timestamps from the last time this frame was drawn are ready
+    gpu_profiler.collect(static_cast<unsigned>(currentFrame));
+    collect_frame_stats();
+    //everything only used by frames the GPU has finished can be destroyed
+    // - with timeline semaphores the progress of the GPU is known exactly
+    // - otherwise the frame just waited on is the newest known to be finished (frames finish in the order they were submitted, they are all on the same queue)
+    frames_completed = std::max(frames_completed, use_timeline_semaphores ? frame_timeline.completed() : frame_values[currentFrame]);
+    deletion_queue.collect(frames_completed);
 
     //get the next image from the swapchain
     //=====================================
     uint32_t imageIndex;
-    const auto new_img_result = vkAcquireNextImageKHR(logical_device.get_device(), swap_chain.get_swap_chain(), UINT64_MAX, semaphores.imageAvailableSemaphore[currentFrame], VK_NULL_HANDLE, &imageIndex);
-    // - the 3rd parameter specifies a timeout in nanoseconds to wait for an image to become available (setting it to UINT64_MAX disables the timeout)
-    // - 4th and 5th parameters specify synchronisation objects that are to be signaled when the presentation engine is finished using the image (That's the point in time where we can start drawing to it.)
-    // - the final parameter is the index in the swap chain of the current image (use this to pick the correct command buffer
-
-    //if the swap chain is no longer adequate (i.e. the window was resized)
-    // - VK_ERROR_OUT_OF_DATE_KHR: The swap chain has become incompatible with the surface and can no longer be used for rendering. Usually happens after a window resize
-    // - VK_SUBOPTIMAL_KHR: The swap chain can still be used to successfully present to the surface, but the surface properties are no longer matched exactly.
-    if (new_img_result == VK_ERROR_OUT_OF_DATE_KHR) {
-        //if the window was resized, the swap chain needs to be recreated
-        recreateSwapChain();
-        return; //cannot present to current swapchain so need to return
-    } else if (new_img_result != VK_SUCCESS && new_img_result != VK_SUBOPTIMAL_KHR) {
-        //some other error
-        throw std::runtime_error("failed to get next swap chain image");
+    if (swap_chain.headless()) {
+        //there is nothing to acquire, the offscreen images are just used in turn
+        imageIndex = static_cast<uint32_t>(frames_submitted % swap_chain.swapChainImages.size());
+    } else {
+        PROFILE_SCOPE("acquire");
+        const auto new_img_result = vkAcquireNextImageKHR(logical_device.get_device(), swap_chain.get_swap_chain(), UINT64_MAX, semaphores.imageAvailableSemaphore[currentFrame], VK_NULL_HANDLE, &imageIndex);
+        // - the 3rd parameter specifies a timeout in nanoseconds to wait for an image to become available (setting it to UINT64_MAX disables the timeout)
+        // - 4th and 5th parameters specify synchronisation objects that are to be signaled when the presentation engine is finished using the image (That's the point in time where we can start drawing to it.)
+        // - the final parameter is the index in the swap chain of the current image (use this to pick the correct command buffer
+
+        //if the swap chain is no longer adequate (i.e. the window was resized)
+        // - VK_ERROR_OUT_OF_DATE_KHR: The swap chain has become incompatible with the surface and can no longer be used for rendering. Usually happens after a window resize
+        // - VK_SUBOPTIMAL_KHR: The swap chain can still be used to successfully present to the surface, but the surface properties are no longer matched exactly.
+        if (new_img_result == VK_ERROR_OUT_OF_DATE_KHR) {
+            //if the window was resized, the swap chain needs to be recreated
+            recreateSwapChain();
+            return; //cannot present to current swapchain so need to return
+        } else if (new_img_result != VK_SUCCESS && new_img_result != VK_SUBOPTIMAL_KHR) {
+            //some other error
+            throw std::runtime_error("failed to get next swap chain image");
+        }
     }
 
     //Check if a previous frame is using this image (i.e. there is its fence to wait on)
     // - if so wait for the image to be finished rendering to
-    if (imagesInFlight[imageIndex] != VK_NULL_HANDLE) {
-        vkWaitForFences(logical_device.get_device(), 1, &imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+    {
+        PROFILE_SCOPE("wait for image");
+        if (use_timeline_semaphores) {
+            frame_timeline.wait(image_values[imageIndex]);
+        } else {
+            if (imagesInFlight[imageIndex] != VK_NULL_HANDLE) {
+                vkWaitForFences(logical_device.get_device(), 1, &imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+            }
+            // Mark the image as now being in use by this frame
+            imagesInFlight[imageIndex] = fences.get_fences()[currentFrame];
+        }
+    }
+
+    //updating the uniform buffers with the camera and transforms from the packet
+    // - the camera is written once and shared by every object
+    {
+        PROFILE_SCOPE("update UBOs");
+        camera_buffer.update(imageIndex, packet.camera);
+        uniform_buffer_object.update(imageIndex, UBO::object{packet.models[CulledObjects::square]});
+        uniform_buffer_object2.update(imageIndex, UBO::object{packet.models[CulledObjects::textured_square1]});
+        uniform_buffer_object3.update(imageIndex, UBO::object{packet.models[CulledObjects::textured_square2]});
     }
-    // Mark the image as now being in use by this frame
-    imagesInFlight[imageIndex] = fences.get_fences()[currentFrame];
 
-    //updating the uniform buffers
-    uniform_buffer_object.update(imageIndex);
-    uniform_buffer_object2.update(imageIndex);
-    uniform_buffer_object3.update(imageIndex);
+    //recording the drawing commands
+    // - the fence for this frame has been waited on so its command buffer is no longer in use
+    // - the packet has already been culled
+    // - when reading the frame back, the image is copied into the buffer for this frame in flight
+    //   (the frame that last used the buffer has been waited for above, and its callback run by collect)
+    const bool read_back = swap_chain.headless() && readback_callback;
+    {
+        PROFILE_SCOPE("record");
+        command_buffers.record(static_cast<unsigned>(currentFrame), imageIndex, packet.visible_objects, read_back ? frame_readback.buffers[currentFrame] : VK_NULL_HANDLE);
+    }
 
     //submitting the command buffer
     //=============================
@@ -237,20 +471,75 @@ void Renderer::drawFrame() {
     submitInfo.pWaitDstStageMask = waitStages;                              //array of pipeline stages which the semaphores will wait
     //the command buffers to execute
     submitInfo.commandBufferCount = 1;                                                  //the number of command buffers to execute
-    submitInfo.pCommandBuffers = &command_buffers.get_command_buffers()[imageIndex];    //want to execute the command buffer associated with the current framebuffer
+    submitInfo.pCommandBuffers = &command_buffers.get_command_buffers()[currentFrame];  //want to execute the command buffer just recorded for this frame
     //setting the semaphores that trigger once rendering starts
     submitInfo.signalSemaphoreCount = 1;                                        //the number of semaphores to trigger
     submitInfo.pSignalSemaphores = &semaphores.renderFinishedSemaphore[currentFrame];         //array of semaphores to trigger
+    //when headless there is no image to wait for and nothing is presented
+    // - so the semaphores for presenting are not used
+    const bool present = !swap_chain.headless();
+    if (!present) {
+        submitInfo.waitSemaphoreCount = 0;
+        submitInfo.signalSemaphoreCount = 0;
+    }
 
-    //again synchronising the CPU and GPU
-    // - needed here and not at the top of the loop because fences are used to make sure images in flight are not being rendered to
-    vkResetFences(logical_device.get_device(), 1, &fences.get_fences()[currentFrame]);
+    //numbering the frame
+    // - with timeline semaphores the number is the value signalled
+    frames_submitted = use_timeline_semaphores ? frame_timeline.next_value() : frames_submitted + 1;
+    frame_values[currentFrame] = frames_submitted;
+    in_flight_stats[currentFrame].frame = frames_submitted;
+    in_flight_stats[currentFrame].counters = command_buffers.get_counters(static_cast<unsigned>(currentFrame));
+
+    VkFence submit_fence = VK_NULL_HANDLE;
+    //with timeline semaphores, the timeline is also signalled with this frames value
+    // - presenting still needs the binary semaphore
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkTimelineSemaphoreSubmitInfo.html
+    const std::array<VkSemaphore, 2> signal_semaphores = {semaphores.renderFinishedSemaphore[currentFrame], frame_timeline.get_semaphore()};
+    const std::array<uint64_t, 2> signal_values = {0, frames_submitted};     //the value for the binary semaphore is ignored
+    if (use_timeline_semaphores) {
+        image_values[imageIndex] = frames_submitted;
+
+        const size_t first_signal = present ? 0 : 1;   //only signalling the timeline if not presenting
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;     //sType must be VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO
+        timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size() - first_signal);
+        timelineInfo.pSignalSemaphoreValues = signal_values.data() + first_signal;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size() - first_signal);
+        submitInfo.pSignalSemaphores = signal_semaphores.data() + first_signal;
+    } else {
+        //again synchronising the CPU and GPU
+        // - needed here and not at the top of the loop because fences are used to make sure images in flight are not being rendered to
+        vkResetFences(logical_device.get_device(), 1, &fences.get_fences()[currentFrame]);
+        submit_fence = fences.get_fences()[currentFrame];
+        last_submit_fence = submit_fence;
+    }
 
 
     //submit the command buffer to the graphics queue for execution
     // - last argument is a fence that can be triggered when the command buffer is finished executing
-    if (vkQueueSubmit(logical_device.graphics_queue, 1, &submitInfo, fences.get_fences()[currentFrame]) != VK_SUCCESS) {
-        throw std::runtime_error("failed to submit draw command buffer!");
+    {
+        PROFILE_SCOPE("submit");
+        gpu_profiler.submitted(Trace::now());
+        pipeline_statistics.submitted();
+        if (vkQueueSubmit(logical_device.graphics_queue, 1, &submitInfo, submit_fence) != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit draw command buffer!");
+        }
+    }
+
+    //handing the pixels over once the frame is finished
+    // - the pointer is taken now, the buffers may be retired before then (but are only destroyed after this runs)
+    if (read_back) {
+        deletion_queue.push(frames_submitted, [this, frame = frames_submitted, pixels = frame_readback.mapped[currentFrame], extent = frame_readback.get_extent()] {
+            if (readback_callback) {
+                readback_callback(frame, pixels, extent);
+            }
+        });
+    }
+
+    //nothing to present when headless, the frame is done once it's submitted
+    if (!present) {
+        currentFrame = (currentFrame + 1) % max_frames_in_flight();
+        return;
     }
 
     //presentation
@@ -265,7 +554,11 @@ void Renderer::drawFrame() {
     presentInfo.pResults = nullptr;             //array of VkResult values to check if every swapchain presentation was successful
                                                 // - not necessary because we are only using a single swapchain
     //submitting the request to present and image to the swap chain
-    const auto pres_result = vkQueuePresentKHR(logical_device.present_queue, &presentInfo);
+    VkResult pres_result;
+    {
+        PROFILE_SCOPE("present");
+        pres_result = vkQueuePresentKHR(logical_device.present_queue, &presentInfo);
+    }
 
     //again if the swapchain is no longer adequate
     // - see above for code comments
@@ -279,7 +572,103 @@ void Renderer::drawFrame() {
     }
 
     //storing the current frame that is being worked on
-    currentFrame = (currentFrame + 1) % max_frames_in_flight;
+    currentFrame = (currentFrame + 1) % max_frames_in_flight();
+}
+
+void Renderer::collect_frame_stats() {
+    //the frame that last used this frame in flight has just been waited for
+    auto& stats = in_flight_stats[currentFrame];
+    if (stats.frame == 0) {
+        return;     //nothing has been submitted by it yet
+    }
+    pipeline_statistics.collect(static_cast<unsigned>(currentFrame), stats.passes);
+
+    {
+        std::lock_guard<std::mutex> lock(frame_stats_mutex);
+        std::swap(frame_stats, stats);  //reusing the old stats' memory for the next frame
+    }
+    stats.frame = 0;
+}
+
+FrameStats Renderer::get_frame_stats() {
+    std::lock_guard<std::mutex> lock(frame_stats_mutex);
+    return frame_stats;
+}
+
+void Renderer::collect_cpu_scopes() {
+    cpu_records.clear();
+    CpuProfiler::drain(cpu_records);
+    const bool tracing = trace.enabled();
+    for (const auto& record : cpu_records) {
+        cpu_stats.add(record);
+        if (tracing) {
+            trace.add({record.name, "cpu", record.thread, record.start, record.end - record.start});
+        }
+    }
+}
+
+std::optional<uint32_t> Renderer::pick(const double cursor_x, const double cursor_y) {
+    //the cursor is in window coordinates, which may not be the same as the framebuffer size (e.g. on high dpi displays)
+    // - there are only pixels when headless
+    int width = window.framebuffer_width, height = window.framebuffer_height;
+    if (!window.headless) {
+        glfwGetWindowSize(window.get_window(), &width, &height);
+    }
+    if (width == 0 || height == 0) {
+        return std::nullopt;
+    }
+
+    //converting to normalised device coordinates
+    // - y is not flipped because the projection already flips it to match vulkan (y pointing down the screen)
+    const float x = 2.0f * static_cast<float>(cursor_x) / static_cast<float>(width) - 1.0f;
+    const float y = 2.0f * static_cast<float>(cursor_y) / static_cast<float>(height) - 1.0f;
+
+    //the ray goes from the point on the near plane to the point on the far plane (depth 0 to 1 in vulkan)
+    const auto inv_view_proj = glm::inverse(UBO::make_camera(window_extent()).view_proj);
+    auto near_point = inv_view_proj * glm::vec4(x, y, 0.0f, 1.0f);
+    auto far_point = inv_view_proj * glm::vec4(x, y, 1.0f, 1.0f);
+    near_point /= near_point.w;
+    far_point /= far_point.w;
+
+    const Ray ray{glm::vec3(near_point), glm::vec3(far_point - near_point)};
+    const auto hit = scene.raycast(ray, 1.0f);  //the direction is the full distance to the far plane
+    if (!hit) {
+        return std::nullopt;
+    }
+    return hit->object;
+}
+
+void Renderer::set_present_settings(const PresentSettings& settings) {
+    std::lock_guard<std::mutex> lock(present_settings_mutex);
+    pending_present_settings = settings;
+    pending_present_settings->frames_in_flight = std::max(settings.frames_in_flight, 1u);     //need at least 1 frame to render
+}
+
+PresentSettings Renderer::get_present_settings() {
+    std::lock_guard<std::mutex> lock(present_settings_mutex);
+    return pending_present_settings ? *pending_present_settings : swap_chain.present_settings;
+}
+
+bool Renderer::has_pending_present_settings() {
+    std::lock_guard<std::mutex> lock(present_settings_mutex);
+    return pending_present_settings.has_value();
+}
+
+void Renderer::apply_pending_present_settings() {
+    std::lock_guard<std::mutex> lock(present_settings_mutex);
+    if (pending_present_settings) {
+        swap_chain.present_settings = *pending_present_settings;
+        pending_present_settings.reset();
+    }
+}
+
+VkExtent2D Renderer::window_extent() const {
+    //never 0 so the projection is always valid (nothing is drawn while the window is minimised anyway)
+    return {static_cast<uint32_t>(std::max(window.framebuffer_width.load(), 1)), static_cast<uint32_t>(std::max(window.framebuffer_height.load(), 1))};
+}
+
+void Renderer::destroy_after_submitted_frames(std::function<void()> destroy) {
+    deletion_queue.push(frames_submitted, std::move(destroy));
 }
 
 void Renderer::endDrawFrame() {
@@ -289,57 +678,136 @@ void Renderer::endDrawFrame() {
 
 void Renderer::recreateSwapChain() {
     //catching the degenerate case of a window size of 0
-    // - in this case just pausing the application until the window size is not 0
-    int width, height;
-    glfwGetFramebufferSize(window.get_window(), &width, &height);   //getting the size of thw window
-    while (width == 0 || height == 0) { //don't do anything until the window is larger than 0
-        glfwGetFramebufferSize(window.get_window(), &width, &height);
-        glfwWaitEvents();
+    // - in this case frames are skipped until the window size is not 0 (drawFrame tries again every frame)
+    // - this is on the render thread so it cannot wait for events, the main thread does that instead
+    if (window.minimised()) {
+        swap_chain_out_of_date = true;
+        return;
     }
+    swap_chain_out_of_date = false;
 
+    //using the new present settings
+    const auto old_frames_in_flight = max_frames_in_flight();
+    apply_pending_present_settings();
 
-    vkDeviceWaitIdle(logical_device.get_device());   //should not touch any resources that may be in flight
+    //the pipelines and render pass only depend on the format of the swapchain images (the viewport and scissor are dynamic)
+    // - the format almost never changes on a resize so can usually keep them
+    const auto old_format = swap_chain.surface_format.format;
+    const auto old_image_count = swap_chain.swapChainImages.size();
 
-    //cleaning up old swap-chain
-    // - cleaning up up everything that needs to be recreated (generally in the reverse order that they are created)
+    //retiring the old swap-chain
+    // - the frames in flight may still be using it and everything made from its images
+    // - so rather than waiting for the device to be idle, they are destroyed once the last frame submitted is finished
     //=========================
-    descriptor_pool.cleanup();
-    descriptor_pool2.cleanup();
-    uniform_buffer_object.cleanup();
-    uniform_buffer_object2.cleanup();
-    uniform_buffer_object3.cleanup();
-    depth_image.cleanup();
-    framebuffers.cleanup();
-    //we could recreate the command pool from scratch but this is wasteful
-    //just cleaning up the existing command buffers
-    // - can then just use the existing command pool to allocate the new command buffers
-    vkFreeCommandBuffers(logical_device.get_device(), command_pool.get_command_pool(), static_cast<unsigned>(command_buffers.get_command_buffers().size()), command_buffers.get_command_buffers().data() );
-    graphics_pipeline1.cleanup();
-    graphics_pipeline2.cleanup();
-    graphics_pipeline3.cleanup();
-    render_pass.cleanup();
-    image_views.cleanup();
-    swap_chain.cleanup();
+    framebuffers.retire(deletion_queue, frames_submitted);
+    depth_image.retire(deletion_queue, frames_submitted);
+    image_views.retire(deletion_queue, frames_submitted);
+    const VkSwapchainKHR old_swap_chain = swap_chain.swapChain;
+    swap_chain.retire(deletion_queue, frames_submitted);
+    if (swap_chain.headless()) {
+        frame_readback.retire(deletion_queue, frames_submitted);    //there is a buffer for each frame in flight, the size of the images
+    }
 
 
     //creating the new swap-chain
     //===========================
-    swap_chain.setup();         //obviously have to re-create the swap-chain
+    swap_chain.setup(old_swap_chain);     //obviously have to re-create the swap-chain (created from the old one)
     image_views.setup();        //image views are directly for the images in the swap chain and so need to be recreated
-    render_pass.setup();        //render pass depends on the format of the swap-chain images
-                                // - the format of the images shouldn't change during window resize but just catching the edge case
-    graphics_pipeline1.setup(); //viewport and scissor changes so the graphics pipeline needs to be recreated
-    graphics_pipeline2.setup(); // - could avoid this using dynamic states for the viewport and the scissors
-    graphics_pipeline3.setup();
+
+    //only the extent dependent resources need to be recreated on a resize
+    // - everything else only changes if the format, number of images, or number of frames in flight change
+    //   (these only happen when the present settings are changed)
+    const bool format_changed = swap_chain.surface_format.format != old_format;
+    const bool image_count_changed = swap_chain.swapChainImages.size() != old_image_count;
+    const bool frames_in_flight_changed = max_frames_in_flight() != old_frames_in_flight;
+    if (frames_in_flight_changed) {
+        //the fences, semaphores and command buffers are per frame in flight and are referenced from outside the frames that use them
+        // - so it is simplest to wait for the device to be idle
+        vkDeviceWaitIdle(logical_device.get_device());
+        frames_completed = frames_submitted;
+        deletion_queue.collect(frames_completed);
+    }
+
+    if (format_changed) {
+        //the render pass depends on the format of the swap-chain images, and the pipelines depend on the render pass
+        // - the format of the images shouldn't change during window resize but just catching the edge case
+        // - the old ones are destroyed once the frames in flight are done with them
+        pipeline_compiler.wait_all();   //the pipelines not needed for the first frame may still be compiling
+        graphics_pipeline1.retire(deletion_queue, frames_submitted);
+        graphics_pipeline2.retire(deletion_queue, frames_submitted);
+        graphics_pipeline3.retire(deletion_queue, frames_submitted);
+        render_pass.retire(deletion_queue, frames_submitted);
+
+        render_pass.setup();
+        pipeline_compiler.add([this] {graphics_pipeline1.setup();});
+        pipeline_compiler.add([this] {graphics_pipeline2.setup();});
+        pipeline_compiler.add([this] {graphics_pipeline3.setup();});
+    }
     depth_image.setup();        //size of the depth image depends on the size of the images in the swap chain
-    framebuffers.setup();       //frame buffers and command buffers depend directly on the swap chain images
-    uniform_buffer_object.setup();  //the UBOs depend on the number of images in the swapchain
-    uniform_buffer_object2.setup();
-    uniform_buffer_object3.cleanup();
-    descriptor_pool.setup();        //depends on the number of images in the swapchain
-    descriptor_pool2.setup();
-    descriptor_set.setup();         //  ditto
-    descriptor_set2.setup();
-    descriptor_set3.setup();
-    command_buffers.setup();
+    framebuffers.setup();       //frame buffers depend directly on the swap chain images
+    if (swap_chain.headless()) {
+        frame_readback.setup(max_frames_in_flight());
+    }
+    if (image_count_changed) {
+        //there is a UBO (and descriptor set) for every image in the swapchain
+        // - the old ones are destroyed once the frames in flight are done with them
+        descriptor_pool.retire(deletion_queue, frames_submitted);
+        descriptor_pool2.retire(deletion_queue, frames_submitted);
+        uniform_buffer_object.retire(deletion_queue, frames_submitted);
+        uniform_buffer_object2.retire(deletion_queue, frames_submitted);
+        uniform_buffer_object3.retire(deletion_queue, frames_submitted);
+        camera_buffer.retire(deletion_queue, frames_submitted);
+
+        uniform_buffer_object.setup();
+        uniform_buffer_object2.setup();
+        uniform_buffer_object3.setup();
+        camera_buffer.setup();
+        descriptor_pool.setup();
+        descriptor_pool2.setup();
+        camera_descriptor_set.setup();
+        descriptor_set.setup();
+        descriptor_set2.setup();
+        descriptor_set3.setup();
+    }
+
+    //the synchronisation objects and command buffers are per frame in flight
+    if (frames_in_flight_changed) {
+        recreateFrameSync();
+    }
+
+    //the pipelines (if they were recreated) must be done before drawing the next frame
+    pipeline_compiler.wait_all();
+
+    //the images of the new swap chain have not been rendered to, but the UBOs for each image may still be used by the frames in flight
+    // - so the first time each image is used has to wait for every frame submitted so far
+    if (use_timeline_semaphores) {
+        image_values.assign(swap_chain.swapChainImages.size(), frames_submitted);
+    } else {
+        imagesInFlight.assign(swap_chain.swapChainImages.size(), last_submit_fence);
+    }
+}
+
+void Renderer::recreateFrameSync() {
+    //must only be called when nothing is in flight
+    // - the timeline semaphore is kept, its value only ever increases so the frames just start from where it is
+    if (!use_timeline_semaphores) {
+        fences.cleanup();
+    }
+    semaphores.cleanup();
+    command_buffers.cleanup();
+    gpu_profiler.cleanup();     //there is a query pool for every frame in flight
+    const bool counting = pipeline_statistics.enabled();
+    pipeline_statistics.cleanup();
+
+    command_buffers.setup(max_frames_in_flight());
+    gpu_profiler.setup(max_frames_in_flight());
+    pipeline_statistics.setup(max_frames_in_flight(), counting);
+    in_flight_stats.assign(max_frames_in_flight(), {});     //the stats of the frames that were in flight are dropped
+    semaphores.setup(max_frames_in_flight());
+    if (!use_timeline_semaphores) {
+        fences.setup(max_frames_in_flight());
+    }
+    frame_values.assign(max_frames_in_flight(), frames_submitted);
+    last_submit_fence = VK_NULL_HANDLE;     //was destroyed with the old fences
+    currentFrame = 0;
 }
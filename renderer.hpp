@@ -15,13 +15,19 @@
 #include "logical_device.hpp"
 #include "surface.hpp"
 #include "swap_chain.hpp"
+#include "present_settings.hpp"
 #include "image_views.hpp"
 #include "graphics_pipeline.hpp"
+#include "pipeline_cache.hpp"
+#include "job_system.hpp"
+#include "pipeline_compiler.hpp"
 #include "framebuffers.hpp"
 #include "command_pool.hpp"
 #include "command_buffers.hpp"
 #include "semaphores.hpp"
 #include "fences.hpp"
+#include "timeline_semaphore.hpp"
+#include "deletion_queue.hpp"
 #include "vertex.hpp"
 #include "vertex_buffer.hpp"
 #include "index_buffer.hpp"
@@ -33,19 +39,74 @@
 #include "texture_view.hpp"
 #include "texture_sampler.hpp"
 #include "depth_image.hpp"
+#include "frame_readback.hpp"
+#include "trace.hpp"
+#include "cpu_profiler.hpp"
+#include "gpu_profiler.hpp"
+#include "pipeline_statistics.hpp"
+#include "frame_stats.hpp"
+#include "startup_timings.hpp"
+#include "scene_bvh.hpp"
+#include "transforms.hpp"
+#include "frame_packet.hpp"
+#include <optional>
+#include <functional>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+
+//where the compiled shaders are
+// - set by cmake to the build directory (the shaders are compiled as part of the build)
+// - if the shaders are embedded (EMBED_SPIRV) these files are never read, only their names are used to find the embedded copy
+#ifndef SHADER_BYTECODE_DIR
+#define SHADER_BYTECODE_DIR "../shader_bytecode/"
+#endif
 
-constexpr std::string_view vertex_shader_location1 = "../shader_bytecode/2D_vc_vert.spv";
-constexpr std::string_view fragment_shader_location1 = "../shader_bytecode/2D_vc_frag.spv";
+//used for both the triangle and the rotating square
+// - which one is picked by the specialization constants (see ShaderConstants)
+constexpr std::string_view vertex_shader_location1 = SHADER_BYTECODE_DIR "2D_vc_vert.spv";
+constexpr std::string_view fragment_shader_location1 = SHADER_BYTECODE_DIR "2D_vc_frag.spv";
 
-constexpr std::string_view vertex_shader_location2 = "../shader_bytecode/2D_vc_mvp_vert.spv";
-constexpr std::string_view fragment_shader_location2 = "../shader_bytecode/2D_vc_mvp_frag.spv";
+constexpr std::string_view vertex_shader_location3 = SHADER_BYTECODE_DIR "2D_vc_mvp_vert_tex.spv";
+constexpr std::string_view fragment_shader_location3 = SHADER_BYTECODE_DIR "2D_vc_mvp_frag_tex.spv";
 
-constexpr std::string_view vertex_shader_location3 = "../shader_bytecode/2D_vc_mvp_vert_tex.spv";
-constexpr std::string_view fragment_shader_location3 = "../shader_bytecode/2D_vc_mvp_frag_tex.spv";
+//the constant_id of the specialization constants in the shaders
+namespace ShaderConstants {
+    //2D_vc.vert
+    enum : uint32_t {
+        use_mvp = 0     //bool -- if the vertices are transformed by the uniform buffer
+    };
+}
 
 constexpr std::string_view texture_image = "../textures/statue.jpg";
 constexpr std::string_view texture_image2 = "../textures/wall.jpg";
 
+constexpr std::string_view pipeline_cache_location = "../pipeline_cache.bin";
+
+//setting this environment variable keeps the pipeline cache in that file instead of pipeline_cache_location
+// - e.g. so the startup benchmark can delete the cache without touching the real one
+constexpr const char* pipeline_cache_variable = "VULKAN_ENGINE_PIPELINE_CACHE";
+
+inline std::string_view pipeline_cache_file() {
+    const char* file = std::getenv(pipeline_cache_variable);
+    return file != nullptr ? std::string_view(file) : pipeline_cache_location;
+}
+
+//setting this environment variable uses fences to synchronise frames even if timeline semaphores are supported
+constexpr const char* binary_sync_variable = "VULKAN_ENGINE_BINARY_SYNC";
+
+//setting this environment variable to a file name records how long each part of the frame takes on the CPU and GPU
+// - written as a chrome trace when the program exits (open it with chrome://tracing or https://ui.perfetto.dev)
+constexpr const char* trace_variable = "VULKAN_ENGINE_TRACE";
+
+//setting this environment variable counts what the GPU does in each pass (vertex/fragment shader invocations, primitives clipped)
+// - see Renderer::get_frame_stats
+constexpr const char* pipeline_statistics_variable = "VULKAN_ENGINE_PIPELINE_STATISTICS";
+
+//setting this environment variable keeps every worker of the job system on its own core (linux only)
+// - stops the workers being moved between cores, at the cost of fighting with anything else running on the machine
+constexpr const char* job_affinity_variable = "VULKAN_ENGINE_PIN_THREADS";
+
 struct Renderer {
     std::vector<Vertex::TWOD_VC> vertices_triangle = {
         {{0.0f, -1.0f}, {1.0f, 1.0f, 1.0f}},
@@ -73,55 +134,128 @@ struct Renderer {
 #ifdef VALDIATION_LAYERS
     explicit Renderer(Window& w) : window(w), debug_messenger(instance), logical_device(physical_device, queue_family), queue_family(physical_device.physicalDevice, surface.surface),
             surface(window, instance), physical_device(instance, surface), swap_chain(window, logical_device, surface, queue_family),
-            image_views(swap_chain, logical_device),
-            graphics_pipeline1(logical_device, swap_chain, render_pass, nullptr, vertex_shader_location1,  fragment_shader_location1),
-           graphics_pipeline2(logical_device, swap_chain, render_pass, &descriptor_set_layout, vertex_shader_location2,  fragment_shader_location2),
-                                   graphics_pipeline3(logical_device, swap_chain, render_pass, &descriptor_set_layout2, vertex_shader_location3,  fragment_shader_location3),
+            image_views(swap_chain, logical_device), pipeline_cache(logical_device, pipeline_cache_file()), jobs(0, std::getenv(job_affinity_variable) != nullptr), pipeline_compiler(jobs), shader_cache(logical_device),
+            graphics_pipeline1(logical_device, render_pass, pipeline_cache, shader_cache, {&camera_set_layout, &descriptor_set_layout}, vertex_shader_location1,  fragment_shader_location1, SpecializationConstants().set(ShaderConstants::use_mvp, false)),
+           graphics_pipeline2(logical_device, render_pass, pipeline_cache, shader_cache, {&camera_set_layout, &descriptor_set_layout}, vertex_shader_location1,  fragment_shader_location1, SpecializationConstants().set(ShaderConstants::use_mvp, true)),
+                                   graphics_pipeline3(logical_device, render_pass, pipeline_cache, shader_cache, {&camera_set_layout, &descriptor_set_layout2}, vertex_shader_location3,  fragment_shader_location3),
            render_pass(logical_device, swap_chain), framebuffers(logical_device, image_views, render_pass, swap_chain, depth_image), command_pool(logical_device, queue_family),
-           command_buffers(logical_device, command_pool, framebuffers, render_pass, swap_chain, graphics_pipeline1, graphics_pipeline2, graphics_pipeline3,vertex_buffer_triangle, vertex_buffer_square, index_buffer_square, descriptor_set, vertex_buffer_square2, descriptor_set2,descriptor_set3),
-                                   semaphores(logical_device), fences(logical_device), vertex_buffer_triangle(logical_device, command_pool, vertices_triangle),
+           command_buffers(logical_device, command_pool, framebuffers, render_pass, swap_chain, graphics_pipeline1, graphics_pipeline2, graphics_pipeline3,vertex_buffer_triangle, vertex_buffer_square, index_buffer_square, camera_descriptor_set, descriptor_set, vertex_buffer_square2, descriptor_set2,descriptor_set3, gpu_profiler, pipeline_statistics),
+                                   gpu_profiler(logical_device, queue_family, trace), pipeline_statistics(logical_device),
+                                   semaphores(logical_device), fences(logical_device), frame_timeline(logical_device), vertex_buffer_triangle(logical_device, command_pool, vertices_triangle),
             vertex_buffer_square(logical_device, command_pool, vertices_square), index_buffer_square(logical_device, command_pool, indices_square), vertex_buffer_square2(logical_device, command_pool, vertices_square2),
             descriptor_set_layout(logical_device), descriptor_set_layout2(logical_device), uniform_buffer_object(logical_device, swap_chain), descriptor_pool(logical_device, swap_chain),
                                    uniform_buffer_object2(logical_device, swap_chain), descriptor_pool2(logical_device, swap_chain),
-                                   uniform_buffer_object3(logical_device, swap_chain),
+                                   uniform_buffer_object3(logical_device, swap_chain), camera_buffer(logical_device, swap_chain, sizeof(UBO::camera)), camera_set_layout(logical_device),
+                                   camera_descriptor_set(logical_device, swap_chain, camera_buffer, descriptor_pool, camera_set_layout),
                                    descriptor_set(logical_device, swap_chain, uniform_buffer_object, descriptor_pool, descriptor_set_layout),
                                    descriptor_set2(logical_device, swap_chain, uniform_buffer_object2, descriptor_pool2, descriptor_set_layout2, texture_sampler, texture_view),
                                    descriptor_set3(logical_device, swap_chain, uniform_buffer_object3, descriptor_pool2, descriptor_set_layout2, texture_sampler, texture_view2),
                                    texture(logical_device, command_pool, texture_image), texture2(logical_device, command_pool, texture_image2),
-                                   texture_view(logical_device, texture), texture_view2(logical_device, texture2), texture_sampler(logical_device), depth_image(logical_device, swap_chain){}
+                                   texture_view(logical_device, texture), texture_view2(logical_device, texture2), texture_sampler(logical_device), depth_image(logical_device, swap_chain), frame_readback(logical_device, swap_chain), transform_updater(jobs){}
 #else
     explicit Renderer(Window& w) : window(w), logical_device(physical_device, queue_family), queue_family(physical_device.physicalDevice, surface.surface),
         surface(window, instance), physical_device(instance, surface) , swap_chain(window, logical_device, surface, queue_family) ,
-        image_views(swap_chain, logical_device),
-       graphics_pipeline1(logical_device, swap_chain, render_pass, nullptr, vertex_shader_location1,  fragment_shader_location1),
-       graphics_pipeline2(logical_device, swap_chain, render_pass, &descriptor_set_layout, vertex_shader_location2,  fragment_shader_location2),
-       graphics_pipeline3(logical_device, swap_chain, render_pass, &descriptor_set_layout2, vertex_shader_location3,  fragment_shader_location3),
+        image_views(swap_chain, logical_device), pipeline_cache(logical_device, pipeline_cache_file()), jobs(0, std::getenv(job_affinity_variable) != nullptr), pipeline_compiler(jobs), shader_cache(logical_device),
+       graphics_pipeline1(logical_device, render_pass, pipeline_cache, shader_cache, {&camera_set_layout, &descriptor_set_layout}, vertex_shader_location1,  fragment_shader_location1, SpecializationConstants().set(ShaderConstants::use_mvp, false)),
+       graphics_pipeline2(logical_device, render_pass, pipeline_cache, shader_cache, {&camera_set_layout, &descriptor_set_layout}, vertex_shader_location1,  fragment_shader_location1, SpecializationConstants().set(ShaderConstants::use_mvp, true)),
+       graphics_pipeline3(logical_device, render_pass, pipeline_cache, shader_cache, {&camera_set_layout, &descriptor_set_layout2}, vertex_shader_location3,  fragment_shader_location3),
         render_pass(logical_device, swap_chain),
         framebuffers(logical_device, image_views, render_pass, swap_chain, depth_image), command_pool(logical_device, queue_family),
-       command_buffers(logical_device, command_pool, framebuffers, render_pass, swap_chain, graphics_pipeline1, graphics_pipeline2, graphics_pipeline3,vertex_buffer_triangle, vertex_buffer_square, index_buffer_square, descriptor_set, vertex_buffer_square2, descriptor_set2,descriptor_set3),
-       semaphores(logical_device), fences(logical_device), vertex_buffer_triangle(logical_device, command_pool, vertices_triangle),
+       command_buffers(logical_device, command_pool, framebuffers, render_pass, swap_chain, graphics_pipeline1, graphics_pipeline2, graphics_pipeline3,vertex_buffer_triangle, vertex_buffer_square, index_buffer_square, camera_descriptor_set, descriptor_set, vertex_buffer_square2, descriptor_set2,descriptor_set3, gpu_profiler, pipeline_statistics),
+                                   gpu_profiler(logical_device, queue_family, trace), pipeline_statistics(logical_device),
+       semaphores(logical_device), fences(logical_device), frame_timeline(logical_device), vertex_buffer_triangle(logical_device, command_pool, vertices_triangle),
             vertex_buffer_square(logical_device, command_pool, vertices_square), index_buffer_square(logical_device, command_pool, indices_square), vertex_buffer_square2(logical_device, command_pool, vertices_square2),
             descriptor_set_layout(logical_device), descriptor_set_layout2(logical_device), uniform_buffer_object(logical_device, swap_chain), descriptor_pool(logical_device, swap_chain),
             uniform_buffer_object2(logical_device, swap_chain), descriptor_pool2(logical_device, swap_chain),
-            uniform_buffer_object3(logical_device, swap_chain),
+            uniform_buffer_object3(logical_device, swap_chain), camera_buffer(logical_device, swap_chain, sizeof(UBO::camera)), camera_set_layout(logical_device),
+                                   camera_descriptor_set(logical_device, swap_chain, camera_buffer, descriptor_pool, camera_set_layout),
                                    descriptor_set(logical_device, swap_chain, uniform_buffer_object, descriptor_pool, descriptor_set_layout),
                                    descriptor_set2(logical_device, swap_chain, uniform_buffer_object2, descriptor_pool2, descriptor_set_layout2, texture_sampler, texture_view),
                                    descriptor_set3(logical_device, swap_chain, uniform_buffer_object3, descriptor_pool2, descriptor_set_layout2, texture_sampler, texture_view2),
                                    texture(logical_device, command_pool, texture_image), texture2(logical_device, command_pool, texture_image2),
-                                   texture_view(logical_device, texture), texture_view2(logical_device, texture2), texture_sampler(logical_device), depth_image(logical_device, swap_chain){}
+                                   texture_view(logical_device, texture), texture_view2(logical_device, texture2), texture_sampler(logical_device), depth_image(logical_device, swap_chain), frame_readback(logical_device, swap_chain), transform_updater(jobs){}
 #endif
+    //makes sure no jobs are still using the members (see the definition)
+    ~Renderer();
+
     void initVulkan();
     void cleanup();
-    void drawFrame();
     void endDrawFrame();
 
+    //the frame is split between two threads
+    // - simulate is called on the main thread, it works out where everything is and what can be seen
+    // - drawFrame is called on the render thread, it records and submits a packet made by simulate
+    // - so the main thread can make the next frame while the last one is being drawn (see main.cpp)
+    [[nodiscard]] FramePacket simulate();
+    void drawFrame(const FramePacket& packet);
+
+    //finding the object under the cursor (in window coordinates, as given by glfwGetCursorPos)
+    // - returns the CulledObjects index of the closest object, if there is one
+    // - main thread only (same as simulate)
+    std::optional<uint32_t> pick(double cursor_x, double cursor_y);
+
+    //changing how frames are presented (e.g. turning off vsync) and paced
+    // - can be called at any time from any thread, the swapchain is recreated at the start of the next frame
+    // - if called before initVulkan, the settings are used from the start
+    void set_present_settings(const PresentSettings& settings);
+    [[nodiscard]] PresentSettings get_present_settings();
+    //the present mode actually used (the policy falls back to other modes if its preferred mode is not supported)
+    // - render thread only
+    [[nodiscard]] VkPresentModeKHR get_present_mode() const {return swap_chain.present_mode;}
+
+    //destroying something once every frame submitted so far has finished on the GPU
+    // - for replacing resources while running (e.g. streaming or hot reloading) without waiting for the device to be idle
+    // - most resources have a retire function that does this for them
+    // - render thread only
+    void destroy_after_submitted_frames(std::function<void()> destroy);
+
     //how many frames should be processed concurrently
-    static constexpr unsigned max_frames_in_flight = 2;
+    [[nodiscard]] unsigned max_frames_in_flight() const {return swap_chain.present_settings.frames_in_flight;}
+
+    //reading the rendered frames back when headless (see Window::makeHeadless)
+    // - called once every frame has finished rendering, with its number (the same as destroy_after_submitted_frames uses)
+    // - the pixels are tightly packed rows in SwapChain::offscreen_format, they are only valid during the call
+    // - called on the render thread (from drawFrame), frames are only copied while a callback is set
+    using ReadbackCallback = std::function<void(uint64_t frame, const void* pixels, VkExtent2D extent)>;
+    void set_frame_readback(ReadbackCallback callback) {readback_callback = std::move(callback);}
+
+    //how long the PROFILE_SCOPEs took (on every thread) over the last few seconds
+    // - only up to the start of the last frame drawn
+    // - render thread only (or once the render thread has stopped)
+    [[nodiscard]] std::vector<ScopeStats::Summary> cpu_scope_stats() const {return cpu_stats.summarise();}
+
+    //what was drawn in the newest frame that has finished on the GPU
+    // - the draw calls, binds, etc. recorded, and what the GPU did in each pass if pipeline_statistics_variable is set
+    // - updated every frame, can be called from any thread
+    [[nodiscard]] FrameStats get_frame_stats();
+
+    //how long each part of initVulkan took, and if the pipeline cache was used
+    [[nodiscard]] const StartupTimings& get_startup_timings() const {return startup_timings;}
+
 
 private:
     size_t currentFrame = 0;    //used for rendering
 
     void recreateSwapChain();   //used whenever the window is resized
+    void recreateFrameSync();   //used when the number of frames in flight changes
+
+    //settings to use the next time the swapchain is recreated
+    // - set by the main thread and used by the render thread, so the mutex guards them and swap_chain.present_settings
+    std::optional<PresentSettings> pending_present_settings;
+    std::mutex present_settings_mutex;
+    bool has_pending_present_settings();
+    void apply_pending_present_settings();
+
+    //if the swapchain could not be recreated because the window was minimised
+    // - it is tried again every frame
+    bool swap_chain_out_of_date = false;
+
+    //the size of the window for the main thread (the swapchain extent belongs to the render thread)
+    [[nodiscard]] VkExtent2D window_extent() const;
+
+    //when the simulation started -- everything is rotating at a fixed rate from then
+    std::chrono::steady_clock::time_point start_time;
+    uint64_t packets_made = 0;
 
     //variables for the window
     Window& window;
@@ -152,9 +286,25 @@ private:
     //The views into the swapchain images (needed for rendering)
     ImageViews image_views;
 
+    //the compiled pipelines from previous runs -- makes creating the graphics pipelines much faster
+    PipelineCache pipeline_cache;
+
+    //the worker threads shared by everything in the renderer that can be split up (transforms, pipeline compilation, texture decoding)
+    // - culling goes through the scene BVH on the main thread, which only visits a few nodes so isn't worth splitting
+    // - the jobs use members declared after this (and their counters), which are destroyed first
+    //   so every job is finished in ~Renderer before any member is destroyed
+    JobSystem jobs;
+    JobCounter texture_decoding;    //the textures being decoded while the device is set up (see initVulkan)
+
+    //compiles the graphics pipelines on the job system
+    PipelineCompiler pipeline_compiler;
+
+    //every shader module -- shared between pipelines and kept when pipelines are recreated
+    ShaderCache shader_cache;
+
     //the graphics pipeline --- how all the rendering gets done
-    GraphicsPipeline<Vertex::TWOD_VC> graphics_pipeline1;    //boring
-    GraphicsPipeline<Vertex::TWOD_VC> graphics_pipeline2;    //MVP
+    GraphicsPipeline<Vertex::TWOD_VC> graphics_pipeline1;    //boring (2D_vc without the MVP transform)
+    GraphicsPipeline<Vertex::TWOD_VC> graphics_pipeline2;    //MVP (2D_vc with the MVP transform)
     GraphicsPipeline<Vertex::TWOD_VT> graphics_pipeline3;    //MVP with textures
 
     //render pass -- how the framebuffer is written to
@@ -164,19 +314,25 @@ private:
     Framebuffers framebuffers;
 
     //UBO -- holds the data for the shader
-    UniformBufferObject1 uniform_buffer_object;
-    UniformBufferObject2 uniform_buffer_object2;
-    UniformBufferObject3 uniform_buffer_object3;
+    // - one for each object (the transforms come from the FramePacket)
+    UniformBufferObject uniform_buffer_object;      //square
+    UniformBufferObject uniform_buffer_object2;     //textured_square1
+    UniformBufferObject uniform_buffer_object3;     //textured_square2
+    //the camera -- shared by every object so it is only written once a frame
+    UniformBufferObject camera_buffer;
 
     //descriptor set layouts -- the layout of the data being passed to the shader
+    // - the camera is a single uniform buffer so it uses the same layout as the square's object data (but at UBO::camera_set)
     DescriptorSetLayout1 descriptor_set_layout;
     DescriptorSetLayout2 descriptor_set_layout2;
+    DescriptorSetLayout1 camera_set_layout;
 
     //descriptor pool --- holds the memory for the descriptor sets
-    DescriptorPool1<1> descriptor_pool;
+    DescriptorPool1<2> descriptor_pool;     //the square and the camera
     DescriptorPool2<2> descriptor_pool2;
 
     //descriptor set -- like command buffers but for descriptors
+    DescriptorSet1 camera_descriptor_set;
     DescriptorSet1 descriptor_set;
     DescriptorSet2 descriptor_set2;
     DescriptorSet2 descriptor_set3;
@@ -187,15 +343,54 @@ private:
     //command buffers -- holds the rendering commands
     CommandBuffers command_buffers;
 
+    //the timings of the frames (see trace_variable)
+    // - the GPU profiler times parts of the command buffers
+    TraceRecorder trace;
+    GpuProfiler gpu_profiler;
+
+    //what each frame drew (see get_frame_stats)
+    // - the stats of each frame in flight are kept until it finishes, then the newest finished frame is handed out under the mutex
+    PipelineStatistics pipeline_statistics;
+    std::vector<FrameStats> in_flight_stats;
+    FrameStats frame_stats;
+    std::mutex frame_stats_mutex;
+    void collect_frame_stats();
+
+    //how long initVulkan took (see get_startup_timings)
+    StartupTimings startup_timings;
+
+    //the timings of the CPU scopes, taken out of CpuProfiler once a frame
+    // - go to the trace as well when it is enabled
+    ScopeStats cpu_stats;
+    std::vector<CpuProfiler::Record> cpu_records;   //kept to not allocate every frame
+    void collect_cpu_scopes();
+
     //semaphores -- tell the GPU certain operations are done
-    Semaphores<max_frames_in_flight> semaphores;
+    Semaphores semaphores;
 
     //fences -- allow for CPU-GPU synchronisation
-    Fences<max_frames_in_flight> fences;
+    Fences fences;
 
     //making sure we don't render to an image that is already in flight
     std::vector<VkFence> imagesInFlight;
 
+    //the timeline semaphore backend (used instead of the fences if supported)
+    // - the GPU sets the timeline to the frames value once it has finished rendering it
+    // - so waiting for a frame or image is just comparing its value with the timeline
+    bool use_timeline_semaphores = false;
+    TimelineSemaphore frame_timeline;
+    std::vector<uint64_t> image_values;     //the value signalled by the last submission that rendered to each swapchain image
+
+    //the number of every frame submitted, so resources can be destroyed once the frames using them are done (see DeletionQueue)
+    // - with timeline semaphores this is the value signalled by the frame
+    uint64_t frames_submitted = 0;          //the number of the last frame submitted
+    uint64_t frames_completed = 0;          //the number of the last frame known to be finished on the GPU
+    std::vector<uint64_t> frame_values;     //the number of the last frame submitted by each frame in flight
+    VkFence last_submit_fence = VK_NULL_HANDLE;     //the fence of the last frame submitted (when not using timeline semaphores)
+
+    //objects waiting for the frames using them to finish before being destroyed
+    DeletionQueue deletion_queue;
+
     //structure to hold the vertex data
     VertexBuffer<Vertex::TWOD_VC> vertex_buffer_triangle;
     VertexBuffer<Vertex::TWOD_VC> vertex_buffer_square;
@@ -218,6 +413,26 @@ private:
 
     //image to hold the values for depth. Used as a test for the output of the fragment shader
     DepthImage depth_image;
+
+    //where the frames are copied to when headless
+    FrameReadback frame_readback;
+    ReadbackCallback readback_callback;
+
+    //the bounds of every object for frustum culling and picking
+    // - the objects are indexed by CulledObjects
+    // - only used by the main thread (simulate and pick)
+    SceneBVH scene;
+
+    //the bounds of every object before it is transformed -- indexed by CulledObjects
+    // - every object is one of the squares (see vertices_square), which are flat and 1 unit across
+    inline static const AABB square_bounds{glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f)};
+    std::array<AABB, CulledObjects::no_objects> object_bounds{};
+
+    //how every object moves -- indexed by CulledObjects like the scene
+    // - every object's model matrix is worked out in one batch in simulate
+    // - only used by the main thread
+    Transforms transforms;
+    TransformUpdater transform_updater;
 };
 
 
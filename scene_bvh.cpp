@@ -0,0 +1,339 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "scene_bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+
+namespace {
+    //the number of buckets the centroids are sorted into when looking for the best split
+    // - testing every possible split is too slow to do on a large scene, and more bins than this barely improves the tree
+    constexpr unsigned no_bins = 12;
+
+    //the distance along the ray to where it enters the box
+    // - returns a negative number if the ray misses
+    float ray_box_distance(const glm::vec3& origin, const glm::vec3& inv_direction, const AABB& box, const float max_distance) {
+        const auto t1 = (box.min - origin) * inv_direction;
+        const auto t2 = (box.max - origin) * inv_direction;
+        const auto t_near = glm::min(t1, t2);
+        const auto t_far = glm::max(t1, t2);
+        const float t_enter = std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f));
+        const float t_exit = std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, max_distance));
+        return t_enter <= t_exit ? t_enter : -1.0f;
+    }
+}
+
+
+void SceneBVH::build(const std::vector<AABB>& object_boxes) {
+    boxes = object_boxes;
+    rebuild();
+}
+
+void SceneBVH::rebuild() {
+    object_indices.resize(boxes.size());
+    for (uint32_t i = 0; i < object_indices.size(); i++) {
+        object_indices[i] = i;
+    }
+    object_leaf.assign(boxes.size(), 0);
+
+    //a binary tree with at least 1 object per leaf has fewer than 2n nodes
+    nodes.clear();
+    nodes.reserve(2 * boxes.size() + 1);
+    if (!boxes.empty()) {
+        build_node(0, 0, static_cast<uint32_t>(boxes.size()), 0);
+    }
+
+    //the bounds in the order of the leaves, for the culling kernels
+    object_position.resize(boxes.size());
+    sorted_bounds.clear();
+    sorted_bounds.reserve(boxes.size());
+    for (uint32_t i = 0; i < object_indices.size(); i++) {
+        object_position[object_indices[i]] = i;
+        sorted_bounds.add(boxes[object_indices[i]]);
+    }
+
+    refit_nodes.clear();
+    node_dirty.assign(nodes.size(), false);
+    area_sum = 0.0;
+    for (const auto& node : nodes) {
+        area_sum += node_cost(node);
+    }
+    built_cost = cost();
+}
+
+uint32_t SceneBVH::build_node(const uint32_t parent, const uint32_t first, const uint32_t count, const uint32_t depth) {
+    const auto index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    //the bounds of the objects, and the bounds of their centers (which is what is split on)
+    AABB box = boxes[object_indices[first]];
+    AABB centers{box.center(), box.center()};
+    for (uint32_t i = first + 1; i < first + count; i++) {
+        const auto& b = boxes[object_indices[i]];
+        box = box.merge(b);
+        centers = centers.merge({b.center(), b.center()});
+    }
+    nodes[index].box = box;
+    nodes[index].first = first;
+    nodes[index].count = count;
+    nodes[index].parent = parent;
+
+    if (count <= max_leaf_size) {
+        for (uint32_t i = first; i < first + count; i++) {
+            object_leaf[object_indices[i]] = index;
+        }
+        return index;
+    }
+
+    //finding the best split using the surface area heuristic
+    // - the cost of a split is the area of each side times the number of objects on that side
+    // - the centroids are sorted into bins along each axis and every boundary between bins is tested
+    // - deep in the tree the objects are just split in half instead, so the depth stays under max_depth however the objects are placed
+    const auto centers_size = centers.max - centers.min;
+    int best_axis = -1;
+    unsigned best_split = 0;
+    float best_cost = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3 && depth < sah_depth; axis++) {
+        if (centers_size[axis] <= 0.0f) {
+            continue;   //every center is in the same place along this axis so it can't be split
+        }
+        const float bin_scale = static_cast<float>(no_bins) / centers_size[axis];
+        const auto bin_of = [&](const uint32_t object) {
+            const auto bin = static_cast<unsigned>((boxes[object].center()[axis] - centers.min[axis]) * bin_scale);
+            return std::min(bin, no_bins - 1);
+        };
+
+        std::array<AABB, no_bins> bin_boxes{};
+        std::array<uint32_t, no_bins> bin_counts{};
+        for (uint32_t i = first; i < first + count; i++) {
+            const auto object = object_indices[i];
+            const auto bin = bin_of(object);
+            bin_boxes[bin] = bin_counts[bin] == 0 ? boxes[object] : bin_boxes[bin].merge(boxes[object]);
+            bin_counts[bin]++;
+        }
+
+        //sweeping from the right to get the area of everything right of each split
+        std::array<float, no_bins> right_area{};
+        std::array<uint32_t, no_bins> right_count{};
+        AABB right_box{};
+        uint32_t right_total = 0;
+        for (unsigned bin = no_bins - 1; bin > 0; bin--) {
+            if (bin_counts[bin] != 0) {
+                right_box = right_total == 0 ? bin_boxes[bin] : right_box.merge(bin_boxes[bin]);
+                right_total += bin_counts[bin];
+            }
+            right_area[bin] = right_total == 0 ? 0.0f : right_box.half_area();
+            right_count[bin] = right_total;
+        }
+
+        //then sweeping from the left, and the split is between bin-1 and bin
+        AABB left_box{};
+        uint32_t left_total = 0;
+        for (unsigned bin = 1; bin < no_bins; bin++) {
+            if (bin_counts[bin-1] != 0) {
+                left_box = left_total == 0 ? bin_boxes[bin-1] : left_box.merge(bin_boxes[bin-1]);
+                left_total += bin_counts[bin-1];
+            }
+            if (left_total == 0 || right_count[bin] == 0) {
+                continue;
+            }
+            const float split_cost = left_box.half_area() * static_cast<float>(left_total) + right_area[bin] * static_cast<float>(right_count[bin]);
+            if (split_cost < best_cost) {
+                best_cost = split_cost;
+                best_axis = axis;
+                best_split = bin;
+            }
+        }
+    }
+
+    //moving the objects left of the split to the front of the range
+    uint32_t left_count = count / 2;
+    if (best_axis != -1) {
+        const float bin_scale = static_cast<float>(no_bins) / centers_size[best_axis];
+        const auto middle = std::partition(object_indices.begin() + first, object_indices.begin() + first + count, [&](const uint32_t object) {
+            const auto bin = static_cast<unsigned>((boxes[object].center()[best_axis] - centers.min[best_axis]) * bin_scale);
+            return std::min(bin, no_bins - 1) < best_split;
+        });
+        left_count = static_cast<uint32_t>(middle - (object_indices.begin() + first));
+    }
+    //every center is in the same place so just splitting the objects in half
+    // - also catches the split putting everything on one side (shouldn't happen but don't want infinite recursion)
+    if (left_count == 0 || left_count == count) {
+        left_count = count / 2;
+    }
+
+    //the left child is always the next node
+    build_node(index, first, left_count, depth + 1);
+    const auto right = build_node(index, first + left_count, count - left_count, depth + 1);
+    nodes[index].right = right;
+
+    return index;
+}
+
+
+void SceneBVH::update(const uint32_t object, const AABB& box) {
+    boxes[object] = box;
+    sorted_bounds.set(object_position[object], box);
+
+    //marking every node from the objects leaf to the root
+    // - can stop as soon as a node is already marked because everything above it is too
+    auto node = object_leaf[object];
+    while (!node_dirty[node]) {
+        node_dirty[node] = true;
+        refit_nodes.push_back(node);
+        if (node == 0) {
+            break;
+        }
+        node = nodes[node].parent;
+    }
+}
+
+void SceneBVH::refit() {
+    if (refit_nodes.empty()) {
+        return;
+    }
+
+    //children always come after their parent in the node array
+    // - so going from the largest index to the smallest updates every child before its parent
+    std::sort(refit_nodes.begin(), refit_nodes.end(), std::greater<>());
+    // - the cost of the tree is updated as each node changes, so checking if it needs rebuilding doesn't visit every node
+    for (const auto index : refit_nodes) {
+        auto& node = nodes[index];
+        area_sum -= node_cost(node);
+        if (node.is_leaf()) {
+            node.box = boxes[object_indices[node.first]];
+            for (uint32_t i = node.first + 1; i < node.first + node.count; i++) {
+                node.box = node.box.merge(boxes[object_indices[i]]);
+            }
+        } else {
+            node.box = nodes[index + 1].box.merge(nodes[node.right].box);
+        }
+        area_sum += node_cost(node);
+        node_dirty[index] = false;
+    }
+    refit_nodes.clear();
+
+    if (needs_rebuild()) {
+        rebuild();
+    }
+}
+
+float SceneBVH::cost() const {
+    //the surface area heuristic cost of the whole tree
+    // - relative to the area of the root so it doesn't change when the whole scene moves or grows
+    if (nodes.empty()) {
+        return 0.0f;
+    }
+    const float root_area = nodes[0].box.half_area();
+    return root_area > 0.0f ? static_cast<float>(area_sum / root_area) : 0.0f;
+}
+
+bool SceneBVH::needs_rebuild() const {
+    return cost() > built_cost * rebuild_threshold;
+}
+
+
+void SceneBVH::query(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+    visible.clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    //a depth first walk has at most one node waiting on the stack for each level, plus both children of the deepest
+    std::array<uint32_t, max_depth + 1> stack;
+    size_t stack_size = 0;
+    stack[stack_size++] = 0;
+    std::array<uint32_t, max_leaf_size> leaf_visible;
+    while (stack_size != 0) {
+        const auto index = stack[--stack_size];
+        const auto& node = nodes[index];
+
+        if (!frustum.intersects(node.box)) {
+            continue;   //nothing below this node can be seen
+        }
+        if (frustum.contains(node.box)) {
+            //everything below this node can be seen so don't need to test any of it
+            visible.insert(visible.end(), object_indices.begin() + node.first, object_indices.begin() + node.first + node.count);
+            continue;
+        }
+
+        if (node.is_leaf()) {
+            //the kernels give positions in object_indices
+            const size_t no_visible = cull_range(frustum, sorted_bounds, node.first, node.first + node.count, leaf_visible.data());
+            for (size_t i = 0; i < no_visible; i++) {
+                visible.push_back(object_indices[leaf_visible[i]]);
+            }
+        } else {
+            stack[stack_size++] = node.right;
+            stack[stack_size++] = index + 1;
+        }
+    }
+}
+
+std::optional<RayHit> SceneBVH::raycast(const Ray& ray, const float max_distance) const {
+    if (nodes.empty()) {
+        return std::nullopt;
+    }
+
+    //dividing once here rather than for every box
+    // - not relying on 1/0 giving infinity because the release build uses -ffinite-math-only
+    glm::vec3 inv_direction;
+    for (int axis = 0; axis < 3; axis++) {
+        const float d = ray.direction[axis];
+        inv_direction[axis] = std::fabs(d) > 1e-20f ? 1.0f / d : std::copysign(1e20f, d);
+    }
+
+    std::optional<RayHit> closest;
+    float closest_distance = max_distance;
+
+    //see query for the size
+    std::array<uint32_t, max_depth + 1> stack;
+    size_t stack_size = 0;
+    if (ray_box_distance(ray.origin, inv_direction, nodes[0].box, closest_distance) >= 0.0f) {
+        stack[stack_size++] = 0;
+    }
+    while (stack_size != 0) {
+        const auto index = stack[--stack_size];
+        const auto& node = nodes[index];
+
+        //a closer hit may have been found since this node was pushed
+        if (ray_box_distance(ray.origin, inv_direction, node.box, closest_distance) < 0.0f) {
+            continue;
+        }
+
+        if (node.is_leaf()) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                const auto object = object_indices[i];
+                const float distance = ray_box_distance(ray.origin, inv_direction, boxes[object], closest_distance);
+                if (distance >= 0.0f && (!closest || distance < closest_distance)) {
+                    closest = RayHit{object, distance};
+                    closest_distance = distance;
+                }
+            }
+            continue;
+        }
+
+        //visiting the closer child first so the further one can hopefully be skipped
+        const float left_distance = ray_box_distance(ray.origin, inv_direction, nodes[index + 1].box, closest_distance);
+        const float right_distance = ray_box_distance(ray.origin, inv_direction, nodes[node.right].box, closest_distance);
+        if (left_distance >= 0.0f && right_distance >= 0.0f) {
+            if (left_distance < right_distance) {
+                stack[stack_size++] = node.right;
+                stack[stack_size++] = index + 1;
+            } else {
+                stack[stack_size++] = index + 1;
+                stack[stack_size++] = node.right;
+            }
+        } else if (left_distance >= 0.0f) {
+            stack[stack_size++] = index + 1;
+        } else if (right_distance >= 0.0f) {
+            stack[stack_size++] = node.right;
+        }
+    }
+
+    return closest;
+}
@@ -0,0 +1,104 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_SCENE_BVH_HPP
+#define VULKAN_ENGINE_SCENE_BVH_HPP
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <limits>
+#include "frustum.hpp"
+#include "frustum_culling.hpp"
+
+//a ray used for picking
+// - direction does not need to be normalised, the hit distance is measured in multiples of it
+struct Ray {
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, 1.0f};
+};
+
+struct RayHit {
+    uint32_t object;    //the index of the object that was hit
+    float distance;     //distance along the ray to the objects bounding box
+};
+
+//bounding volume hierarchy over the bounds of every object in the scene
+// - used so culling and picking only have to look at the parts of the scene near the camera/ray rather than every object
+// - the nodes are stored in a single array in depth first order
+//   > the left child of a node is always the next node in the array, so only the right child needs to be stored
+//   > every node also stores the range of objects in its subtree, so a node entirely inside the frustum can be added without visiting its children
+// - the bounds of the objects are also kept in the same order as object_indices, so a leaf is tested with the culling kernels (see cull_range)
+// - objects are referred to by the index they had in the vector passed to build
+struct SceneBVH {
+    struct Node {
+        AABB box;
+        uint32_t first = 0;     //first entry in object_indices covered by this node
+        uint32_t count = 0;     //number of objects in this nodes subtree
+        uint32_t right = 0;     //index of the right child (0 for leaves -- the root can never be a right child)
+        uint32_t parent = 0;
+
+        [[nodiscard]] bool is_leaf() const {return right == 0;}
+    };
+
+    //building the tree from scratch
+    // - splits use the surface area heuristic so nodes are as tight as possible
+    void build(const std::vector<AABB>& object_boxes);
+
+    //changing the bounds of an object (e.g. after its transform changes)
+    // - the tree is not updated until refit is called, so many objects can be moved at once
+    void update(uint32_t object, const AABB& box);
+
+    //updating the boxes of the nodes above every object that moved
+    // - only touches the nodes on the paths from the moved objects to the root (each node at most once)
+    // - refitting keeps the structure of the tree so it gets slower to query if objects move far from where they were built
+    //   > if this has happened (see needs_rebuild) the tree is rebuilt instead
+    void refit();
+
+    //if the tree has become worse than rebuild_threshold times its cost when it was built
+    // - the cost is kept up to date by refit, so this doesn't walk the tree
+    [[nodiscard, gnu::pure]] bool needs_rebuild() const;
+
+    //fills `visible' with the index of every object whose bounds are (at least partially) inside the frustum
+    // - the indices are in the order of the leaves of the tree, not sorted
+    void query(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+    //the closest object whose bounds are hit by the ray
+    [[nodiscard, gnu::pure]] std::optional<RayHit> raycast(const Ray& ray, float max_distance = std::numeric_limits<float>::max()) const;
+
+    [[nodiscard]] size_t size() const {return boxes.size();}
+    [[nodiscard]] const std::vector<Node>& get_nodes() const {return nodes;}
+
+    //the number of objects stored in a leaf before it is split
+    static constexpr uint32_t max_leaf_size = 4;
+    //how much the cost of the tree can grow by refitting before it is rebuilt
+    static constexpr float rebuild_threshold = 2.0f;
+    //the deepest a leaf can be, so walking the tree can use a fixed size stack
+    // - nodes deeper than sah_depth are split in half rather than with the surface area heuristic, which needs at most 32 more levels for 2^32 objects
+    static constexpr uint32_t max_depth = 64;
+    static constexpr uint32_t sah_depth = max_depth / 2;
+
+private:
+    std::vector<Node> nodes;
+    std::vector<uint32_t> object_indices;   //the objects sorted so that every node covers a contiguous range
+    std::vector<uint32_t> object_leaf;      //the leaf each object is in
+    std::vector<AABB> boxes;                //the bounds of every object
+    std::vector<uint32_t> object_position;  //where each object is in object_indices
+    ObjectBounds sorted_bounds;             //the bounds of object_indices[i] at index i
+    std::vector<uint32_t> refit_nodes;      //nodes whose boxes need to be recomputed on the next refit
+    std::vector<bool> node_dirty;           //so a node is only added to refit_nodes once
+
+    float built_cost = 0.0f;    //the cost of the tree when it was built
+    double area_sum = 0.0;      //the sum of node_cost over every node (see cost), a double so adding and taking away every refit doesn't drift
+
+    //building the tree from boxes
+    void rebuild();
+    uint32_t build_node(uint32_t parent, uint32_t first, uint32_t count, uint32_t depth);
+    //how much a node adds to the cost of the tree
+    [[nodiscard]] static float node_cost(const Node& node) {return node.is_leaf() ? node.box.half_area() * static_cast<float>(node.count) : node.box.half_area();}
+    [[nodiscard, gnu::pure]] float cost() const;
+};
+
+
+#endif //VULKAN_ENGINE_SCENE_BVH_HPP
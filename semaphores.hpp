@@ -6,7 +6,7 @@
 #define VULKAN_ENGINE_SEMAPHORES_HPP
 
 #include <vulkan/vulkan.h>
-#include <array>
+#include <vector>
 #include "logical_device.hpp"
 #include <stdexcept>
 
@@ -14,14 +14,17 @@
 //semaphores are used to synchronise swap chain events (e.g. drawing and rendering)
 // - semaphores are used to synchronize operations within or across command queues
 // - as opposed to fences which are mainly designed to synchronize your application itself with rendering operation
-template <unsigned no_semahores>
+// - one of each for every frame in flight (which can change while running, see PresentSettings)
 struct Semaphores {
-    std::array<VkSemaphore, no_semahores> imageAvailableSemaphore{};
-    std::array<VkSemaphore, no_semahores> renderFinishedSemaphore{};
+    std::vector<VkSemaphore> imageAvailableSemaphore;
+    std::vector<VkSemaphore> renderFinishedSemaphore;
 
     explicit Semaphores(LogicalDevice &d) : device(d) {}
 
-    void setup()  {
+    void setup(const unsigned no_semaphores)  {
+        imageAvailableSemaphore.resize(no_semaphores);
+        renderFinishedSemaphore.resize(no_semaphores);
+
         //creating semaphores is trivial
         VkSemaphoreCreateInfo semaphoreInfo{};      //https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkSemaphoreCreateInfo.html
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;  //sType must be VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
@@ -52,6 +55,8 @@ struct Semaphores {
         for (auto& img_semaphore : imageAvailableSemaphore) {
             vkDestroySemaphore(device.get_device(), img_semaphore, nullptr);
         }
+        renderFinishedSemaphore.clear();
+        imageAvailableSemaphore.clear();
 
     }
 
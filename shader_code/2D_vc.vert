@@ -1,5 +1,23 @@
 #version 450
 
+//if the vertices are transformed by the MVP matrices
+// - set when the pipeline is created so the same shader is used for both the boring triangle and the rotating square
+// - the branch is removed by the driver when the pipeline is compiled, so it costs nothing
+layout(constant_id = 0) const bool USE_MVP = true;
+
+//the camera -- the same for every object (see UBO::camera)
+// - still must be bound when USE_MVP is false because it is referenced in the shader
+layout(set = 0, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 proj;
+    mat4 view_proj;
+} camera;
+
+//the rotation data -- different for every object (see UBO::object)
+layout(set = 1, binding = 0) uniform Object {
+    mat4 model;
+} object;
+
 //outputting the colour of each vertex
 layout(location = 0) out vec3 fragColor;
 
@@ -11,8 +29,13 @@ layout(location = 1) in vec3 inColor;
 void main() {
     //gl_VertexIndex contains the index of the current vertex
     //gl_Position is the built in output
-    gl_Position = vec4(inPosition, 0.0, 1.0);
+    if (USE_MVP) {
+        //outputting the rotated vertex data
+        gl_Position = camera.view_proj * object.model * vec4(inPosition, 0.0, 1.0);
+    } else {
+        gl_Position = vec4(inPosition, 0.0, 1.0);
+    }
 
     //setting the variable to pass
     fragColor = inColor;
-}
\ No newline at end of file
+}
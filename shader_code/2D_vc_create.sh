@@ -1,2 +0,0 @@
-glslc 2D_vc.vert -o ../shader_bytecode/2D_vc_vert.spv
-glslc 2D_vc.frag -o ../shader_bytecode/2D_vc_frag.spv
@@ -1,2 +0,0 @@
-glslc 2D_vc_mvp.vert -o ../shader_bytecode/2D_vc_mvp_vert.spv
-glslc 2D_vc_mvp.frag -o ../shader_bytecode/2D_vc_mvp_frag.spv
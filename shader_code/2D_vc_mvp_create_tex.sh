@@ -1,2 +0,0 @@
-glslc 2D_vc_mvp_tex.vert -o ../shader_bytecode/2D_vc_mvp_vert_tex.spv
-glslc 2D_vc_mvp_tex.frag -o ../shader_bytecode/2D_vc_mvp_frag_tex.spv
@@ -8,7 +8,7 @@ layout(location = 0) out vec4 outColor;
 layout(location = 0) in vec2 fragTexCoord;
 
 //getting the image data
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 1) uniform sampler2D texSampler;
 
 //main is run for every fragment
 void main() {
@@ -1,11 +1,16 @@
 #version 450
 
-//the rotation data
-layout(binding = 0) uniform UniformBufferObject1 {
-    mat4 model;
+//the camera -- the same for every object (see UBO::camera)
+layout(set = 0, binding = 0) uniform Camera {
     mat4 view;
     mat4 proj;
-} ubo;
+    mat4 view_proj;
+} camera;
+
+//the rotation data -- different for every object (see UBO::object)
+layout(set = 1, binding = 0) uniform Object {
+    mat4 model;
+} object;
 
 //outputting the colour of each vertex
 layout(location = 0) out vec2 fragTexCoord;
@@ -19,7 +24,7 @@ void main() {
     //gl_VertexIndex contains the index of the current vertex
     //gl_Position is the built in output
     //outputting the rotated vertex data
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 0.0, 1.0);
+    gl_Position = camera.view_proj * object.model * vec4(inPosition, 0.0, 1.0);
 
     //setting the variable to pass to the fragment shader
     fragTexCoord = inTexCoord;
@@ -0,0 +1,20 @@
+#version 450
+
+//how much the texture is darkened
+// - set when the pipeline is created, so each pipeline in the benchmark is actually a different pipeline
+layout(constant_id = 0) const float TINT = 1.0;
+
+//there is no built in variable to output the colour
+//location specifies the index of the framebuffer
+layout(location = 0) out vec4 outColor;
+
+//grabbing the texture coordinates outputted from the vertex shader
+layout(location = 0) in vec2 fragTexCoord;
+
+//getting the image data
+layout(binding = 1) uniform sampler2D texSampler;
+
+//main is run for every fragment
+void main() {
+    outColor = texture(texSampler, fragTexCoord) * vec4(vec3(TINT), 1.0);
+}
@@ -0,0 +1,21 @@
+#version 450
+
+//where the object is drawn, set for every draw call
+// - xy is the centre in clip space, z is the scale
+// - push constants rather than a uniform buffer so the benchmark doesn't need a descriptor per object
+layout(push_constant) uniform ObjectData {
+    vec4 offset_scale;
+} object;
+
+//outputting the texture coordinates of each vertex
+layout(location = 0) out vec2 fragTexCoord;
+
+//inputting the vertex positions and texture coordinates
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+
+//main is invoked for every vertex
+void main() {
+    gl_Position = vec4(inPosition * object.offset_scale.z + object.offset_scale.xy, 0.0, 1.0);
+    fragTexCoord = inTexCoord;
+}
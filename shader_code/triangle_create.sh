@@ -1,2 +0,0 @@
-glslc triangle.vert -o ../shader_bytecode/triangle_vert.spv
-glslc triangle.frag -o ../shader_bytecode/triangle_frag.spv
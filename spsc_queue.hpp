@@ -0,0 +1,105 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_SPSC_QUEUE_HPP
+#define VULKAN_ENGINE_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+//a fixed size queue for handing objects from one thread to another
+// - exactly one thread may push and exactly one (other) thread may pop
+// - pushing and popping never take a lock, the blocking versions only sleep when the queue is full/empty
+// - the capacity bounds how far the producer can run ahead of the consumer
+template <typename T, size_t capacity>
+class SpscQueue {
+    static_assert(capacity > 0, "the queue must be able to hold something");
+
+public:
+    //adding to the back of the queue (producer thread only)
+    // - value is only moved from if there was space
+    bool try_push(T& value) {
+        const auto t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+        slots[t % capacity] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        signal();
+        return true;
+    }
+
+    //taking from the front of the queue (consumer thread only)
+    bool try_pop(T& value) {
+        const auto h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[h % capacity]);
+        head.store(h + 1, std::memory_order_release);
+        signal();
+        return true;
+    }
+
+    //waiting for space then pushing
+    // - returns false (without pushing) if the queue is closed
+    bool push(T& value) {
+        while (true) {
+            const auto e = events.load(std::memory_order_acquire);     //read before trying so a pop in between is not missed
+            if (closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (try_push(value)) {
+                return true;
+            }
+            events.wait(e, std::memory_order_acquire);
+        }
+    }
+
+    //waiting for something then popping
+    // - returns false once the queue is closed, even if there was something left in it
+    bool pop(T& value) {
+        while (true) {
+            const auto e = events.load(std::memory_order_acquire);
+            if (closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (try_pop(value)) {
+                return true;
+            }
+            events.wait(e, std::memory_order_acquire);
+        }
+    }
+
+    //waking up both threads and making every blocking push/pop fail (can be called from any thread)
+    void close() {
+        closed.store(true, std::memory_order_release);
+        signal();
+    }
+
+    [[nodiscard]] bool is_closed() const {return closed.load(std::memory_order_acquire);}
+
+private:
+    //waking up the other thread if it is waiting in push/pop
+    void signal() {
+        events.fetch_add(1, std::memory_order_release);
+        events.notify_all();
+    }
+
+    std::array<T, capacity> slots{};
+
+    //the number of objects ever pushed and popped
+    // - on separate cache lines so the two threads don't fight over them
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+
+    //changes every time something is pushed or popped, or the queue is closed (what the blocking versions wait on)
+    alignas(64) std::atomic<uint32_t> events{0};
+    std::atomic<bool> closed{false};
+};
+
+#endif //VULKAN_ENGINE_SPSC_QUEUE_HPP
@@ -0,0 +1,49 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_STARTUP_TIMINGS_HPP
+#define VULKAN_ENGINE_STARTUP_TIMINGS_HPP
+
+#include <chrono>
+#include <vector>
+
+//how long each part of starting the renderer took (see Renderer::initVulkan)
+// - the phases run one after another, so together they are the whole startup
+// - the pipelines compile on other threads while the later phases run, so their phase is only the time left waiting for them
+struct StartupTimings {
+    struct Phase {
+        const char* name;   //must live for the whole program (i.e. a string literal)
+        double ms;
+    };
+    std::vector<Phase> phases;
+
+    bool pipeline_cache_hit = false;    //if there was a pipeline cache from a previous run
+
+    //starting the first phase
+    void start() {
+        phases.clear();
+        phase_start = std::chrono::steady_clock::now();
+    }
+
+    //ending the current phase and starting the next
+    void end_phase(const char* name) {
+        const auto now = std::chrono::steady_clock::now();
+        phases.push_back({name, std::chrono::duration<double, std::milli>(now - phase_start).count()});
+        phase_start = now;
+    }
+
+    [[nodiscard]] double total_ms() const {
+        double total = 0.0;
+        for (const auto& phase : phases) {
+            total += phase.ms;
+        }
+        return total;
+    }
+
+private:
+    std::chrono::steady_clock::time_point phase_start{};
+};
+
+
+#endif //VULKAN_ENGINE_STARTUP_TIMINGS_HPP
@@ -7,6 +7,9 @@
 #include <stdexcept>
 
 void Surface::setup() {
+    if (headless()) {
+        return; //nothing is presented
+    }
     const auto did_create_surface = glfwCreateWindowSurface(instance.get_instance(), window.get_window(), nullptr, &surface);
     if (did_create_surface != VK_SUCCESS) {
         throw std::runtime_error("failed to create window surface");
@@ -14,5 +17,8 @@ void Surface::setup() {
 }
 
 void Surface::cleanup() const {
+    if (headless()) {
+        return;
+    }
     vkDestroySurfaceKHR(instance.get_instance(), surface, nullptr);    //simply destroying the surface
 }
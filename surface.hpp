@@ -20,6 +20,9 @@ struct Surface {
     void cleanup() const;
     VkSurfaceKHR& get_surface() {return surface;}
 
+    //there is no surface when rendering headless (it stays as VK_NULL_HANDLE)
+    [[nodiscard]] bool headless() const {return window.headless;}
+
     VkSurfaceKHR surface{};
 };
 
@@ -5,9 +5,16 @@
 #include "swap_chain.hpp"
 #include "swap_chain_details.hpp"
 #include "queue_family.hpp"
+#include "texture.hpp"
 #include <stdexcept>
+#include <algorithm>
+
+void SwapChain::setup(VkSwapchainKHR old_swap_chain) {
+    if (headless()) {
+        setup_offscreen();
+        return;
+    }
 
-void SwapChain::setup() {
     //firstly getting all supported swap chains
     SwapChainDetails swap_chain_details;
     swap_chain_details.query_swap_chain_support(device.physical_device.get_device(), surface.get_surface());
@@ -15,17 +22,12 @@ void SwapChain::setup() {
     //then selecting the best swap chain features that are supported
     // - these best features are defined in the SwapChainDetails struct
     surface_format = swap_chain_details.chooseSwapSurfaceFormat();
-    present_mode = swap_chain_details.chooseSwapPresentMode();
-    extent = swap_chain_details.chooseSwapExtent(window.get_window());
+    present_mode = swap_chain_details.chooseSwapPresentMode(present_settings.policy);
+    extent = swap_chain_details.chooseSwapExtent(window);
 
     //number of images to use in the swap chain
-    //recommended to use 1 more than the minimum
-    unsigned no_images = swap_chain_details.capabilities.minImageCount + 1;
-    //making sure that 1 more than the minimum is posible.
-    //if not just taking the minimum
-    if (swap_chain_details.capabilities.maxImageCount > 0 && no_images > swap_chain_details.capabilities.maxImageCount) {  //maxImageCount=0 means no maximum
-        no_images = swap_chain_details.capabilities.maxImageCount;
-    }
+    // - clamped to the range the surface supports
+    const unsigned no_images = swap_chain_details.chooseImageCount(present_settings.image_count);
 
     //putting the queue indices in an array (as required by vulkan)
     const unsigned queue_family_indices[] = {queue_family.graphicsFamily.value(), queue_family.presentFamily.value()};
@@ -72,12 +74,14 @@ void SwapChain::setup() {
     //only useful when recreating the swapchain
     // - swapchain needs to be recreated when the window is resized
     //this would be a reference to old swapchain that the new one is created from
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    // - the old swap chain is retired (can't acquire new images from it) but must still be destroyed
+    createInfo.oldSwapchain = old_swap_chain;
 
 
     //creation struct is filled, so the swapchain can be created
     const auto creation_result = vkCreateSwapchainKHR(device.get_device(), &createInfo, nullptr, &swapChain);
     if (creation_result != VK_SUCCESS) {
+        swapChain = VK_NULL_HANDLE;     //so cleanup doesn't destroy whatever was left in it
         throw std::runtime_error("failed to create swap chain");
     }
 
@@ -91,3 +95,51 @@ void SwapChain::setup() {
 
 }
 
+
+void SwapChain::setup_offscreen() {
+    //there is nothing to choose from, the images are just made how they are needed
+    surface_format = {offscreen_format, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+    extent = {static_cast<uint32_t>(window.framebuffer_width.load()), static_cast<uint32_t>(window.framebuffer_height.load())};
+
+    //an image for every frame in flight unless more were asked for (nothing is waiting to be presented so more aren't needed)
+    const unsigned no_images = std::max(present_settings.image_count, present_settings.frames_in_flight);
+
+    swapChainImages.resize(no_images);
+    offscreen_memory.resize(no_images);
+    for (unsigned i = 0; i < no_images; i++) {
+        //rendered to then copied out of (if the frames are read back)
+        create_image(device, extent.width, extent.height, offscreen_format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, swapChainImages[i], offscreen_memory[i]);
+    }
+}
+
+void SwapChain::cleanup() {
+    if (headless()) {
+        for (size_t i = 0; i < swapChainImages.size(); i++) {
+            vkDestroyImage(device.get_device(), swapChainImages[i], nullptr);
+            vkFreeMemory(device.get_device(), offscreen_memory[i], nullptr);
+        }
+        swapChainImages.clear();
+        offscreen_memory.clear();
+        return;
+    }
+    vkDestroySwapchainKHR(device.get_device(), swapChain, nullptr);
+}
+
+void SwapChain::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    if (headless()) {
+        deletion_queue.push(frame, [d = device.get_device(), images = std::move(swapChainImages), memory = std::move(offscreen_memory)] {
+            for (size_t i = 0; i < images.size(); i++) {
+                vkDestroyImage(d, images[i], nullptr);
+                vkFreeMemory(d, memory[i], nullptr);
+            }
+        });
+        swapChainImages.clear();
+        offscreen_memory.clear();
+        return;
+    }
+    deletion_queue.push(frame, [d = device.get_device(), old_swap_chain = swapChain] {
+        vkDestroySwapchainKHR(d, old_swap_chain, nullptr);
+    });
+    swapChain = VK_NULL_HANDLE;     //the deletion queue owns it now, so cleanup must not destroy it as well
+}
@@ -9,14 +9,28 @@
 #include "logical_device.hpp"
 #include "surface.hpp"
 #include "queue_family.hpp"
+#include "present_settings.hpp"
+#include "deletion_queue.hpp"
 
 #include <vector>
 
 struct SwapChain {
     SwapChain(Window& w, LogicalDevice& d, Surface &s, QueueFamily &q) : window(w), device(d), surface(s), queue_family(q) {}
 
-    void setup();
-    void cleanup() const {vkDestroySwapchainKHR(device.get_device(), swapChain, nullptr);}
+    //the old swap chain is given when recreating the swap chain (e.g. after a resize)
+    // - lets the driver reuse its resources and keep presenting its images while the new one is made
+    void setup(VkSwapchainKHR old_swap_chain = VK_NULL_HANDLE);
+    void cleanup();
+    //destroying the swap chain once `frame' has finished on the GPU
+    // - the swap chain is still valid until then so must be given to setup as the old swap chain
+    //   (swapChain is VK_NULL_HANDLE afterwards, so take a copy of it before retiring)
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
+
+    //when rendering headless there is no swap chain (swapChain is VK_NULL_HANDLE)
+    // - swapChainImages are offscreen images instead, so everything made from them works the same
+    // - the images are left in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL by the render pass so they can be read back
+    [[nodiscard]] bool headless() const {return surface.headless();}
+    static constexpr VkFormat offscreen_format = VK_FORMAT_B8G8R8A8_SRGB;   //the same as the preferred swap chain format
 
     //whether pixels that are obscured by other windows should be deleted
     // - better performance if set to true
@@ -27,6 +41,11 @@ struct SwapChain {
     VkSwapchainKHR swapChain{}; //handle to the swap chain
 
     std::vector<VkImage> swapChainImages;   //reference to the images created by the swapchain
+    std::vector<VkDeviceMemory> offscreen_memory;   //the memory for the images when headless (the swap chain owns its images otherwise)
+
+    //how the images are presented and how many there are
+    // - used the next time the swap chain is setup
+    PresentSettings present_settings{};
 
     //the settings of the swap chain
     VkSurfaceFormatKHR surface_format{};    //colour format (e.g. rgba)
@@ -34,6 +53,9 @@ struct SwapChain {
     VkExtent2D extent{};                    //resolution for images in the swapchain
 
 private:
+    //making the images to render to when headless
+    void setup_offscreen();
+
     Window& window;
     LogicalDevice& device;
     Surface &surface;
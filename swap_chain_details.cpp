@@ -42,11 +42,11 @@ VkSurfaceFormatKHR SwapChainDetails::chooseSwapSurfaceFormat() {
     return formats[0];
 }
 
-VkPresentModeKHR SwapChainDetails::chooseSwapPresentMode() {
-    //finding the present mode that is best
-    for (const auto& availablePresentMode : presentModes) {
-        if (availablePresentMode == best_present_mode) {
-            return availablePresentMode;
+VkPresentModeKHR SwapChainDetails::chooseSwapPresentMode(const PresentPolicy policy) const {
+    //finding the present mode the policy wants most that is available
+    for (const auto wanted : present_mode_preferences(policy)) {
+        if (std::find(presentModes.begin(), presentModes.end(), wanted) != presentModes.end()) {
+            return wanted;
         }
     }
 
@@ -54,7 +54,20 @@ VkPresentModeKHR SwapChainDetails::chooseSwapPresentMode() {
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
-VkExtent2D SwapChainDetails::chooseSwapExtent(GLFWwindow* window) const {
+uint32_t SwapChainDetails::chooseImageCount(const uint32_t requested) const {
+    //recommended to use 1 more than the minimum
+    // - so there is always an image to render to while the driver is using the others
+    uint32_t no_images = requested == 0 ? capabilities.minImageCount + 1 : requested;
+    no_images = std::max(no_images, capabilities.minImageCount);
+    //making sure that number of images is posible.
+    //if not just taking the maximum
+    if (capabilities.maxImageCount > 0 && no_images > capabilities.maxImageCount) {  //maxImageCount=0 means no maximum
+        no_images = capabilities.maxImageCount;
+    }
+    return no_images;
+}
+
+VkExtent2D SwapChainDetails::chooseSwapExtent(const Window& window) const {
     //some window managers do not allow the resolution of the swap chain to differ from the resolution of the window
     //those that can differ have capabilities.currentExtent.width and capabilities.currentExtent.height = UINT32_MAX
     //when they can't differ, just return the extent (match the swapchain resolution to the window resolution)
@@ -67,11 +80,9 @@ VkExtent2D SwapChainDetails::chooseSwapExtent(GLFWwindow* window) const {
         //finding the resolution of the window in pixels
         // - note this is not the same as the window width and height defined when creating the window.
         //   these are screen coordinates. Most of the time they match up with pixels but not always.
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-
-        //making sure the size is between the min and max allowed
-        VkExtent2D actualExtent{ static_cast<unsigned>(width), static_cast<unsigned>(height) };
+        // - using the size stored by the window because glfwGetFramebufferSize can only be called on the main thread
+        //   (the swapchain is recreated on the render thread)
+        VkExtent2D actualExtent{ static_cast<unsigned>(window.framebuffer_width.load()), static_cast<unsigned>(window.framebuffer_height.load()) };
         actualExtent.width = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
         actualExtent.height = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
 
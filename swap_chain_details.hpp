@@ -7,7 +7,8 @@
 
 #include <vulkan/vulkan.h>
 #include <vector>
-#include <GLFW/glfw3.h>
+#include "present_settings.hpp"
+#include "window.hpp"
 
 //swapchain is like a framebuffer
 //it is a queue of images that are waiting to be presented to the screen
@@ -38,18 +39,19 @@ struct SwapChainDetails {
 
     //function to return the best surface format out of those in `formats'
     VkSurfaceFormatKHR chooseSwapSurfaceFormat();
-    //function to return the best present mode out of those in `presentModes'
-    VkPresentModeKHR chooseSwapPresentMode();
+    //function to return the best present mode out of those in `presentModes' for the policy
+    // - the first of the policies preferred modes that is supported
+    [[nodiscard]] VkPresentModeKHR chooseSwapPresentMode(PresentPolicy policy) const;
+    //the number of images to ask for in the swapchain
+    // - 0 means 1 more than the minimum (recommended)
+    [[nodiscard]] uint32_t chooseImageCount(uint32_t requested) const;
     //choosing the resolution for the swapchain (based on the window resolution)
-    VkExtent2D chooseSwapExtent(GLFWwindow* window) const;
+    VkExtent2D chooseSwapExtent(const Window& window) const;
 
     //specifying what the best format would be for the swap chain (i.e. framebuffer)
     // - in this case srgb would be best
     static constexpr VkFormat best_format = VK_FORMAT_B8G8R8A8_SRGB;    //the format that we want to the swap chain to have
     static constexpr VkColorSpaceKHR best_colour_space = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR; //the best colour space to have
-
-    //specifying the best present mode
-    static constexpr VkPresentModeKHR best_present_mode = VK_PRESENT_MODE_FIFO_KHR;
 };
 
 
@@ -71,7 +71,7 @@ void create_image(LogicalDevice device, unsigned width, unsigned height, VkForma
     allocInfo.memoryTypeIndex = findMemoryType(device.physical_device, memRequirements.memoryTypeBits, properties);    //finding the best memory type to use
 
     //actually allocating the memory
-    if (vkAllocateMemory(device.get_device(), &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
+    if (allocate_device_memory(device, allocInfo, imageMemory) != VK_SUCCESS) {
         throw std::runtime_error("failed to allocate image memory!");
     }
 
@@ -188,13 +188,12 @@ void copy_buffer_to_image(LogicalDevice device, CommandPool command_pool, VkBuff
 
 
 
-void Texture::setup() {
+void Texture::load() {
     //loading the image using stb_image
     //=================================
     int texture_width, texture_height, texture_channels;    //channel holds the number of vales per pixel (i.e. 3 for rgb and 4 for rgba)
     stbi_uc* pixels = stbi_load(texture_path.data(), &texture_width, &texture_height, &texture_channels, STBI_rgb_alpha);   //cannot be const - stbi_image_free does not work then
     //STBI_rgb_alpha value forces the image to be loaded with an alpha channel, even if it doesn't have one
-    VkDeviceSize imageSize = texture_width * texture_height * 4;    //could also do *texture_channels instead of 4, but we know the number of texture channels is 4
 
     //checking to make sure the image was indeed loaded
     if (!pixels) {
@@ -203,6 +202,25 @@ void Texture::setup() {
         throw std::runtime_error(err_message);
     }
 
+    decoded = {pixels, stbi_image_free};
+    decoded_width = static_cast<unsigned>(texture_width);
+    decoded_height = static_cast<unsigned>(texture_height);
+}
+
+void Texture::setup() {
+    if (!decoded) {
+        load();
+    }
+
+    //uploading the pixels
+    // - the image data is freed even if uploading fails
+    const auto pixels = std::move(decoded);
+    setup(pixels.get(), decoded_width, decoded_height);
+}
+
+void Texture::setup(const unsigned char* pixels, const unsigned texture_width, const unsigned texture_height) {
+    const VkDeviceSize imageSize = VkDeviceSize{texture_width} * texture_height * 4;    //4 bytes per pixel (rgba)
+
     //create a buffer in host visible to memory to copy the pixels into
     //==================================================================
     VkBuffer stagingBuffer;
@@ -213,8 +231,6 @@ void Texture::setup() {
     vkMapMemory(device.get_device(), stagingBufferMemory, 0, imageSize, 0, &data);
     memcpy(data, pixels, imageSize);
     vkUnmapMemory(device.get_device(), stagingBufferMemory);
-    //now that the data is copied into the staging buffer, the image data is no longer needed
-    stbi_image_free(pixels);
 
 
 
@@ -228,7 +244,7 @@ void Texture::setup() {
     transition_image_layout(device, command_pool, textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
     //actually copying the data into the image
-    copy_buffer_to_image(device, command_pool, stagingBuffer, textureImage, static_cast<unsigned>(texture_width), static_cast<unsigned>(texture_height));
+    copy_buffer_to_image(device, command_pool, stagingBuffer, textureImage, texture_width, texture_height);
 
     //transitioning the image into a layout for optimal shader access
     transition_image_layout(device, command_pool, textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
@@ -244,3 +260,12 @@ void Texture::cleanup() {
     vkFreeMemory(device.get_device(), textureImageMemory, nullptr);
 
 }
+
+void Texture::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    deletion_queue.push(frame, [d = device.get_device(), old_image = textureImage, old_memory = textureImageMemory] {
+        vkDestroyImage(d, old_image, nullptr);
+        vkFreeMemory(d, old_memory, nullptr);
+    });
+    textureImage = VK_NULL_HANDLE;
+    textureImageMemory = VK_NULL_HANDLE;
+}
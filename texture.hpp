@@ -5,9 +5,11 @@
 #ifndef VULKAN_ENGINE_TEXTURE_HPP
 #define VULKAN_ENGINE_TEXTURE_HPP
 
+#include <memory>
 #include <string_view>
 #include "logical_device.hpp"
 #include "command_pool.hpp"
+#include "deletion_queue.hpp"
 
 struct Texture {
     //could set up the shader to access the pixel values in the shader
@@ -19,8 +21,19 @@ struct Texture {
 
     Texture(LogicalDevice &d, CommandPool &p, const std::string_view path) : device(d), command_pool(p), texture_path(path) {}
 
+    //decoding the image at texture_path without touching vulkan
+    // - decoding is the slow part of loading a texture, so this can be run as a job while the rest of the renderer is set up
+    // - setup uploads the decoded pixels (and decodes them itself if load wasn't called)
+    void load();
+    //loading the image at texture_path
     void setup();
+    //using pixels already in memory instead of a file (e.g. generated ones)
+    // - the pixels are tightly packed rows of 8 bit rgba
+    void setup(const unsigned char* rgba_pixels, unsigned width, unsigned height);
     void cleanup();
+    //destroying the image once `frame' has finished on the GPU
+    // - setup can be called straight away to load the texture again (e.g. when it has changed on disk)
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
 
     const std::string_view texture_path;
 
@@ -30,6 +43,10 @@ struct Texture {
 private:
     LogicalDevice& device;
     CommandPool &command_pool;
+
+    //the pixels from load, freed once uploaded
+    std::unique_ptr<unsigned char, void(*)(void*)> decoded{nullptr, nullptr};
+    unsigned decoded_width = 0, decoded_height = 0;
 };
 
 //helper function to create images
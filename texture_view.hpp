@@ -14,6 +14,13 @@ struct TextureView {
 
     void setup();
     void cleanup() { vkDestroyImageView(device.get_device(), textureImageView, nullptr); }
+    //destroying the view once `frame' has finished on the GPU
+    void retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+        deletion_queue.push(frame, [d = device.get_device(), old_view = textureImageView] {
+            vkDestroyImageView(d, old_view, nullptr);
+        });
+        textureImageView = VK_NULL_HANDLE;
+    }
 
     [[nodiscard]] VkImageView get_view() const {return textureImageView;}
 
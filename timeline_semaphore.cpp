@@ -0,0 +1,53 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "timeline_semaphore.hpp"
+#include <stdexcept>
+
+void TimelineSemaphore::setup() {
+    //the type of semaphore is given by chaining a struct onto the regular create info
+    VkSemaphoreTypeCreateInfo typeInfo{};   //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkSemaphoreTypeCreateInfo.html
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;  //sType must be VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;            //a timeline semaphore rather than a binary one
+    typeInfo.initialValue = 0;                                      //the value of the counter to start with
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;  //sType must be VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device.get_device(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timeline semaphore");
+    }
+    last_value = 0;
+    completed_value = 0;
+}
+
+void TimelineSemaphore::cleanup() {
+    vkDestroySemaphore(device.get_device(), semaphore, nullptr);
+}
+
+uint64_t TimelineSemaphore::completed() {
+    //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/vkGetSemaphoreCounterValue.html
+    if (vkGetSemaphoreCounterValue(device.get_device(), semaphore, &completed_value) != VK_SUCCESS) {
+        throw std::runtime_error("failed to get the value of the timeline semaphore");
+    }
+    return completed_value;
+}
+
+void TimelineSemaphore::wait(const uint64_t value) {
+    //most of the time the value has already been reached, so there is no need to ask the driver
+    if (value <= completed_value) {
+        return;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};     //https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkSemaphoreWaitInfo.html
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;     //sType must be VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO
+    waitInfo.semaphoreCount = 1;                                //the number of semaphores to wait on
+    waitInfo.pSemaphores = &semaphore;                          //the semaphores to wait on
+    waitInfo.pValues = &value;                                  //the value each semaphore must reach
+    if (vkWaitSemaphores(device.get_device(), &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error("failed to wait for timeline semaphore");
+    }
+    completed_value = value;
+}
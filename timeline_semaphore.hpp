@@ -0,0 +1,42 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_TIMELINE_SEMAPHORE_HPP
+#define VULKAN_ENGINE_TIMELINE_SEMAPHORE_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "logical_device.hpp"
+
+//a semaphore with a counter that only ever increases (core in vulkan 1.2)
+// - the GPU sets the counter to a value when a submission finishes, and the CPU (or other submissions) can wait for the counter to reach a value
+// - so a single semaphore can replace a fence for every frame in flight: each submission signals the next value,
+//   and checking if a submission is done is just comparing its value with the counter
+// - https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkSemaphoreTypeCreateInfo.html
+struct TimelineSemaphore {
+    explicit TimelineSemaphore(LogicalDevice &d) : device(d) {}
+
+    void setup();
+    void cleanup();
+
+    //the value the next submission should signal
+    // - values must be signalled in increasing order
+    [[nodiscard]] uint64_t next_value() {return ++last_value;}
+
+    //the highest value the GPU has reached (asks the driver)
+    [[nodiscard]] uint64_t completed();
+    //blocking until the GPU reaches the value
+    void wait(uint64_t value);
+
+    [[nodiscard]] VkSemaphore& get_semaphore() {return semaphore;}
+
+private:
+    LogicalDevice &device;
+    VkSemaphore semaphore{};
+    uint64_t last_value = 0;        //the last value given to a submission
+    uint64_t completed_value = 0;   //the highest value the GPU is known to have reached
+};
+
+
+#endif //VULKAN_ENGINE_TIMELINE_SEMAPHORE_HPP
@@ -0,0 +1,85 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t Trace::thread_id() {
+    static std::atomic<uint32_t> next_id = gpu_thread + 1;
+    thread_local const uint32_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void TraceRecorder::start(std::string output_file) {
+    file = std::move(output_file);
+    events.reserve(4096);
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::add(const TraceEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (events.size() < max_events) {
+        events.push_back(event);
+    }
+}
+
+//the names are string literals from the program, but escaping them anyway so the file is always valid json
+static void write_string(std::ofstream& out, const char* str) {
+    out << '"';
+    for (const char* c = str; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+void TraceRecorder::write() {
+    if (!enabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ofstream out(file);
+    if (!out.is_open()) {
+        throw std::runtime_error("failed to open trace file " + file);
+    }
+
+    //the times are in microseconds
+    // - starting from the first event so the numbers stay small
+    int64_t first = INT64_MAX;
+    for (const auto& event : events) {
+        first = std::min(first, event.start);
+    }
+
+    out << std::fixed << std::setprecision(3);     //to the ns
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    //naming the GPU "thread" so it is obvious which events are on the GPU
+    out << R"({"name":"thread_name","ph":"M","pid":1,"tid":0,"args":{"name":"GPU"}})";
+    for (const auto& event : events) {
+        //"X" is a complete event (start and duration)
+        out << ",\n{\"name\":";
+        write_string(out, event.name);
+        out << ",\"cat\":";
+        write_string(out, event.category);
+        out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+            << ",\"ts\":" << static_cast<double>(event.start - first) / 1000.0
+            << ",\"dur\":" << static_cast<double>(event.duration) / 1000.0 << "}";
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        throw std::runtime_error("failed to write trace file " + file);
+    }
+}
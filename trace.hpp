@@ -0,0 +1,61 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_TRACE_HPP
+#define VULKAN_ENGINE_TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//recording how long parts of the frame take on the CPU and GPU, and writing them out as a chrome trace
+// - the CPU times come from the PROFILE_SCOPEs (see cpu_profiler.hpp)
+// - the file can be opened with chrome://tracing or https://ui.perfetto.dev
+// - https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU (the trace event format)
+namespace Trace {
+    //nanoseconds on the clock all the events use
+    [[nodiscard]] int64_t now();
+
+    //a small number for the calling thread (the thread ids in the trace)
+    // - 0 is used for the GPU
+    [[nodiscard]] uint32_t thread_id();
+    constexpr uint32_t gpu_thread = 0;
+}
+
+struct TraceEvent {
+    const char* name;       //must live for the whole program (i.e. a string literal)
+    const char* category;   //e.g. cpu or gpu
+    uint32_t thread;
+    int64_t start;          //ns, see Trace::now
+    int64_t duration;       //ns
+};
+
+//every event recorded while tracing
+// - events can be added from any thread
+struct TraceRecorder {
+    //starting to record, the trace is written to output_file by write
+    // - events are ignored until this is called, so tracing costs (almost) nothing when it isn't used
+    void start(std::string output_file);
+    [[nodiscard]] bool enabled() const {return recording.load(std::memory_order_relaxed);}
+
+    void add(const TraceEvent& event);
+
+    //writing every event recorded to the output file
+    // - does nothing if tracing was never started
+    void write();
+
+    //events are dropped after this many so a long run can't use all the memory (~64MB)
+    static constexpr size_t max_events = size_t{1} << 21;
+
+private:
+    std::atomic<bool> recording = false;
+    std::string file;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+};
+
+
+#endif //VULKAN_ENGINE_TRACE_HPP
@@ -0,0 +1,348 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#include "transforms.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+namespace {
+    //the angle an object has turned through is wrapped to [-pi, pi] before taking its sin and cos
+    // - the time keeps growing, so without this the angle soon gets too large for the vectorised sincos (and for float) to be accurate
+    // - worked out in double, so stays accurate for centuries at any reasonable speed
+    constexpr double two_pi = 6.283185307179586;
+    constexpr double one_over_two_pi = 0.15915494309189535;
+
+    float wrapped_angle(const float speed, const double time) {
+        const double angle = static_cast<double>(speed) * time;
+        return static_cast<float>(angle - two_pi * std::nearbyint(angle * one_over_two_pi));
+    }
+}
+
+
+void transform_range_scalar(const Transforms& transforms, const double time, const glm::mat4& view_proj, const size_t begin, const size_t end, glm::mat4* models, glm::mat4* mvps) {
+    for (size_t i = begin; i < end; i++) {
+        const float angle = wrapped_angle(transforms.angular_speed[i], time);
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        const float a_x = transforms.axis_x[i], a_y = transforms.axis_y[i], a_z = transforms.axis_z[i];
+        const float k = transforms.scale[i];
+
+        //the same matrix as glm::rotate, with every column scaled
+        // - https://en.wikipedia.org/wiki/Rotation_matrix#Rotation_matrix_from_axis_and_angle
+        const float t_x = (1.0f - c) * a_x, t_y = (1.0f - c) * a_y, t_z = (1.0f - c) * a_z;
+        auto& m = models[i];
+        m[0] = glm::vec4((c + t_x*a_x) * k, (t_x*a_y + s*a_z) * k, (t_x*a_z - s*a_y) * k, 0.0f);
+        m[1] = glm::vec4((t_y*a_x - s*a_z) * k, (c + t_y*a_y) * k, (t_y*a_z + s*a_x) * k, 0.0f);
+        m[2] = glm::vec4((t_z*a_x + s*a_y) * k, (t_z*a_y - s*a_x) * k, (c + t_z*a_z) * k, 0.0f);
+        m[3] = glm::vec4(transforms.position_x[i], transforms.position_y[i], transforms.position_z[i], 1.0f);
+
+        if (mvps != nullptr) {
+            mvps[i] = view_proj * m;
+        }
+    }
+}
+
+
+namespace {
+    //constants for the vectorised sin and cos (from the Cephes library -- http://www.netlib.org/cephes/)
+    // - the angle is reduced to [-pi/4, pi/4] by taking off the nearest multiple of pi/2
+    // - pi/2 is split into 3 parts so the reduction stays exact for larger angles (Cody-Waite reduction)
+    // - the polynomials are then accurate to about 1 ulp over the reduced range
+    constexpr float two_over_pi = 0.636619772367581343f;
+    constexpr float pi_over_2_a = 1.5703125f;
+    constexpr float pi_over_2_b = 4.837512969970703125e-4f;
+    constexpr float pi_over_2_c = 7.54978995489188216e-8f;
+    constexpr float sin_p0 = -1.9515295891e-4f, sin_p1 = 8.3321608736e-3f, sin_p2 = -1.6666654611e-1f;
+    constexpr float cos_p0 = 2.443315711809948e-5f, cos_p1 = -1.388731625493765e-3f, cos_p2 = 4.166664568298827e-2f;
+}
+
+
+#ifdef __SSE2__
+namespace {
+    //sin and cos of 4 angles at once
+    // - the quadrant the angle was in picks which polynomial is sin and which is cos, and their signs
+    //   (sin(x + q*pi/2) is sin(x), cos(x), -sin(x), -cos(x) for q = 0,1,2,3)
+    void sincos_sse(const __m128 x, __m128& sin_out, __m128& cos_out) {
+        const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(two_over_pi)));    //rounds to nearest
+        const __m128 qf = _mm_cvtepi32_ps(q);
+        __m128 y = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(pi_over_2_a)));
+        y = _mm_sub_ps(y, _mm_mul_ps(qf, _mm_set1_ps(pi_over_2_b)));
+        y = _mm_sub_ps(y, _mm_mul_ps(qf, _mm_set1_ps(pi_over_2_c)));
+        const __m128 z = _mm_mul_ps(y, y);
+
+        __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sin_p0), z), _mm_set1_ps(sin_p1));
+        s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(sin_p2));
+        s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), y), y);
+
+        __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cos_p0), z), _mm_set1_ps(cos_p1));
+        c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(cos_p2));
+        c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+        c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+        //odd quadrants swap sin and cos (SSE2 has no blend so using and/andnot/or)
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        const __m128 sin_abs = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+        const __m128 cos_abs = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+        //moving bit 1 of the quadrant into the sign bit
+        // - sin is negative in quadrants 2 and 3, cos in quadrants 1 and 2
+        const __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+        const __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+        sin_out = _mm_xor_ps(sin_abs, sin_sign);
+        cos_out = _mm_xor_ps(cos_abs, cos_sign);
+    }
+
+    //wrapped_angle for 4 objects at once
+    // - SSE2 has no double rounding instruction so the number of turns goes through an int (fine for up to 2^31 turns)
+    __m128 wrapped_angle_sse(const __m128 speed, const __m128d time) {
+        const auto wrap = [](const __m128d angle) {
+            const __m128d turns = _mm_cvtepi32_pd(_mm_cvtpd_epi32(_mm_mul_pd(angle, _mm_set1_pd(one_over_two_pi))));   //rounds to nearest
+            return _mm_cvtpd_ps(_mm_sub_pd(angle, _mm_mul_pd(turns, _mm_set1_pd(two_pi))));
+        };
+        const __m128 low = wrap(_mm_mul_pd(_mm_cvtps_pd(speed), time));
+        const __m128 high = wrap(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(speed, speed)), time));
+        return _mm_movelh_ps(low, high);
+    }
+
+    //the kernels work out every element of 4 matrices as a structure of arrays (m[column][row] holds that element for each object)
+    // - this turns them back into 4 column major matrices
+    void store_matrices_sse(const __m128 (&m)[4][4], glm::mat4* out) {
+        for (int col = 0; col < 4; col++) {
+            __m128 c0 = m[col][0], c1 = m[col][1], c2 = m[col][2], c3 = m[col][3];
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(&out[0][col][0], c0);
+            _mm_storeu_ps(&out[1][col][0], c1);
+            _mm_storeu_ps(&out[2][col][0], c2);
+            _mm_storeu_ps(&out[3][col][0], c3);
+        }
+    }
+}
+
+void transform_range_sse(const Transforms& transforms, const double time, const glm::mat4& view_proj, const size_t begin, const size_t end, glm::mat4* models, glm::mat4* mvps) {
+    //broadcasting every element of the view projection matrix once, rather than once per group of objects
+    __m128 vp[4][4];
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            vp[col][row] = _mm_set1_ps(view_proj[col][row]);
+        }
+    }
+    const __m128d t = _mm_set1_pd(time);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 s, c;
+        sincos_sse(wrapped_angle_sse(_mm_loadu_ps(&transforms.angular_speed[i]), t), s, c);
+        const __m128 a_x = _mm_loadu_ps(&transforms.axis_x[i]);
+        const __m128 a_y = _mm_loadu_ps(&transforms.axis_y[i]);
+        const __m128 a_z = _mm_loadu_ps(&transforms.axis_z[i]);
+        const __m128 k = _mm_loadu_ps(&transforms.scale[i]);
+
+        //see the scalar version
+        const __m128 one_minus_c = _mm_sub_ps(one, c);
+        const __m128 t_x = _mm_mul_ps(one_minus_c, a_x), t_y = _mm_mul_ps(one_minus_c, a_y), t_z = _mm_mul_ps(one_minus_c, a_z);
+        const __m128 s_x = _mm_mul_ps(s, a_x), s_y = _mm_mul_ps(s, a_y), s_z = _mm_mul_ps(s, a_z);
+
+        __m128 m[4][4];
+        m[0][0] = _mm_mul_ps(_mm_add_ps(c, _mm_mul_ps(t_x, a_x)), k);
+        m[0][1] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(t_x, a_y), s_z), k);
+        m[0][2] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t_x, a_z), s_y), k);
+        m[1][0] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t_y, a_x), s_z), k);
+        m[1][1] = _mm_mul_ps(_mm_add_ps(c, _mm_mul_ps(t_y, a_y)), k);
+        m[1][2] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(t_y, a_z), s_x), k);
+        m[2][0] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(t_z, a_x), s_y), k);
+        m[2][1] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t_z, a_y), s_x), k);
+        m[2][2] = _mm_mul_ps(_mm_add_ps(c, _mm_mul_ps(t_z, a_z)), k);
+        m[0][3] = m[1][3] = m[2][3] = zero;
+        m[3][0] = _mm_loadu_ps(&transforms.position_x[i]);
+        m[3][1] = _mm_loadu_ps(&transforms.position_y[i]);
+        m[3][2] = _mm_loadu_ps(&transforms.position_z[i]);
+        m[3][3] = one;
+        store_matrices_sse(m, models + i);
+
+        if (mvps != nullptr) {
+            //column j of the mvp is view_proj * (column j of the model)
+            // - the bottom row of the model is always (0, 0, 0, 1) so only the last column needs the 4th column of view_proj
+            __m128 mvp[4][4];
+            for (int col = 0; col < 4; col++) {
+                for (int row = 0; row < 4; row++) {
+                    __m128 e = _mm_add_ps(_mm_mul_ps(vp[0][row], m[col][0]), _mm_mul_ps(vp[1][row], m[col][1]));
+                    e = _mm_add_ps(e, _mm_mul_ps(vp[2][row], m[col][2]));
+                    mvp[col][row] = col == 3 ? _mm_add_ps(e, vp[3][row]) : e;
+                }
+            }
+            store_matrices_sse(mvp, mvps + i);
+        }
+    }
+
+    //the objects left over that don't fill an entire register
+    transform_range_scalar(transforms, time, view_proj, i, end, models, mvps);
+}
+#endif
+
+
+#ifdef __AVX2__
+namespace {
+    __m256 mul_add(const __m256 a, const __m256 b, const __m256 c) {
+#ifdef __FMA__
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    __m256 mul_sub(const __m256 a, const __m256 b, const __m256 c) {
+#ifdef __FMA__
+        return _mm256_fmsub_ps(a, b, c);
+#else
+        return _mm256_sub_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    //wrapped_angle for 8 objects at once (AVX can round doubles directly)
+    __m256 wrapped_angle_avx2(const __m256 speed, const __m256d time) {
+        const auto wrap = [](const __m256d angle) {
+            const __m256d turns = _mm256_round_pd(_mm256_mul_pd(angle, _mm256_set1_pd(one_over_two_pi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            return _mm256_cvtpd_ps(_mm256_sub_pd(angle, _mm256_mul_pd(turns, _mm256_set1_pd(two_pi))));
+        };
+        const __m128 low = wrap(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(speed)), time));
+        const __m128 high = wrap(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(speed, 1)), time));
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+    }
+
+    //see the SSE version for comments
+    void sincos_avx2(const __m256 x, __m256& sin_out, __m256& cos_out) {
+        const __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(two_over_pi)));
+        const __m256 qf = _mm256_cvtepi32_ps(q);
+        __m256 y = _mm256_sub_ps(x, _mm256_mul_ps(qf, _mm256_set1_ps(pi_over_2_a)));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(qf, _mm256_set1_ps(pi_over_2_b)));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(qf, _mm256_set1_ps(pi_over_2_c)));
+        const __m256 z = _mm256_mul_ps(y, y);
+
+        __m256 s = mul_add(_mm256_set1_ps(sin_p0), z, _mm256_set1_ps(sin_p1));
+        s = mul_add(s, z, _mm256_set1_ps(sin_p2));
+        s = mul_add(_mm256_mul_ps(s, z), y, y);
+
+        __m256 c = mul_add(_mm256_set1_ps(cos_p0), z, _mm256_set1_ps(cos_p1));
+        c = mul_add(c, z, _mm256_set1_ps(cos_p2));
+        c = _mm256_mul_ps(_mm256_mul_ps(c, z), z);
+        c = _mm256_add_ps(_mm256_sub_ps(c, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.0f));
+
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+        const __m256 sin_abs = _mm256_blendv_ps(s, c, swap);
+        const __m256 cos_abs = _mm256_blendv_ps(c, s, swap);
+
+        const __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+        const __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+        sin_out = _mm256_xor_ps(sin_abs, sin_sign);
+        cos_out = _mm256_xor_ps(cos_abs, cos_sign);
+    }
+
+    //the same transpose as _MM_TRANSPOSE4_PS but on both 128 bit halves at once
+    // - the low half of each result is a column of objects 0-3, the high half the same column of objects 4-7
+    void store_matrices_avx2(const __m256 (&m)[4][4], glm::mat4* out) {
+        for (int col = 0; col < 4; col++) {
+            const __m256 t0 = _mm256_unpacklo_ps(m[col][0], m[col][1]);
+            const __m256 t1 = _mm256_unpackhi_ps(m[col][0], m[col][1]);
+            const __m256 t2 = _mm256_unpacklo_ps(m[col][2], m[col][3]);
+            const __m256 t3 = _mm256_unpackhi_ps(m[col][2], m[col][3]);
+            const __m256 c[4] = {
+                _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+                _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))
+            };
+            for (int obj = 0; obj < 4; obj++) {
+                _mm_storeu_ps(&out[obj][col][0], _mm256_castps256_ps128(c[obj]));
+                _mm_storeu_ps(&out[obj + 4][col][0], _mm256_extractf128_ps(c[obj], 1));
+            }
+        }
+    }
+}
+
+void transform_range_avx2(const Transforms& transforms, const double time, const glm::mat4& view_proj, const size_t begin, const size_t end, glm::mat4* models, glm::mat4* mvps) {
+    //see the SSE version for comments
+    __m256 vp[4][4];
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            vp[col][row] = _mm256_set1_ps(view_proj[col][row]);
+        }
+    }
+    const __m256d t = _mm256_set1_pd(time);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 s, c;
+        sincos_avx2(wrapped_angle_avx2(_mm256_loadu_ps(&transforms.angular_speed[i]), t), s, c);
+        const __m256 a_x = _mm256_loadu_ps(&transforms.axis_x[i]);
+        const __m256 a_y = _mm256_loadu_ps(&transforms.axis_y[i]);
+        const __m256 a_z = _mm256_loadu_ps(&transforms.axis_z[i]);
+        const __m256 k = _mm256_loadu_ps(&transforms.scale[i]);
+
+        const __m256 one_minus_c = _mm256_sub_ps(one, c);
+        const __m256 t_x = _mm256_mul_ps(one_minus_c, a_x), t_y = _mm256_mul_ps(one_minus_c, a_y), t_z = _mm256_mul_ps(one_minus_c, a_z);
+        const __m256 s_x = _mm256_mul_ps(s, a_x), s_y = _mm256_mul_ps(s, a_y), s_z = _mm256_mul_ps(s, a_z);
+
+        __m256 m[4][4];
+        m[0][0] = _mm256_mul_ps(mul_add(t_x, a_x, c), k);
+        m[0][1] = _mm256_mul_ps(mul_add(t_x, a_y, s_z), k);
+        m[0][2] = _mm256_mul_ps(mul_sub(t_x, a_z, s_y), k);
+        m[1][0] = _mm256_mul_ps(mul_sub(t_y, a_x, s_z), k);
+        m[1][1] = _mm256_mul_ps(mul_add(t_y, a_y, c), k);
+        m[1][2] = _mm256_mul_ps(mul_add(t_y, a_z, s_x), k);
+        m[2][0] = _mm256_mul_ps(mul_add(t_z, a_x, s_y), k);
+        m[2][1] = _mm256_mul_ps(mul_sub(t_z, a_y, s_x), k);
+        m[2][2] = _mm256_mul_ps(mul_add(t_z, a_z, c), k);
+        m[0][3] = m[1][3] = m[2][3] = zero;
+        m[3][0] = _mm256_loadu_ps(&transforms.position_x[i]);
+        m[3][1] = _mm256_loadu_ps(&transforms.position_y[i]);
+        m[3][2] = _mm256_loadu_ps(&transforms.position_z[i]);
+        m[3][3] = one;
+        store_matrices_avx2(m, models + i);
+
+        if (mvps != nullptr) {
+            __m256 mvp[4][4];
+            for (int col = 0; col < 4; col++) {
+                for (int row = 0; row < 4; row++) {
+                    __m256 e = mul_add(vp[0][row], m[col][0], col == 3 ? vp[3][row] : zero);
+                    e = mul_add(vp[1][row], m[col][1], e);
+                    mvp[col][row] = mul_add(vp[2][row], m[col][2], e);
+                }
+            }
+            store_matrices_avx2(mvp, mvps + i);
+        }
+    }
+
+    //finishing off with the narrower kernel
+    transform_range_sse(transforms, time, view_proj, i, end, models, mvps);
+}
+#endif
+
+
+void transform_range(const Transforms& transforms, const double time, const glm::mat4& view_proj, const size_t begin, const size_t end, glm::mat4* models, glm::mat4* mvps) {
+#if defined(__AVX2__)
+    transform_range_avx2(transforms, time, view_proj, begin, end, models, mvps);
+#elif defined(__SSE2__)
+    transform_range_sse(transforms, time, view_proj, begin, end, models, mvps);
+#else
+    transform_range_scalar(transforms, time, view_proj, begin, end, models, mvps);
+#endif
+}
+
+
+
+void TransformUpdater::update(const Transforms& transforms, const double time, const glm::mat4& view_proj, glm::mat4* models, glm::mat4* mvps) const {
+    //every chunk writes to its own part of the output so no joining is needed afterwards
+    jobs.parallel_for(transforms.size(), min_objects_per_thread, [&](size_t, const size_t begin, const size_t end) {
+        transform_range(transforms, time, view_proj, begin, end, models, mvps);
+    });
+}
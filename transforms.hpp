@@ -0,0 +1,96 @@
+//
+// Created by jacob on 19/10/26.
+//
+
+#ifndef VULKAN_ENGINE_TRANSFORMS_HPP
+#define VULKAN_ENGINE_TRANSFORMS_HPP
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include "job_system.hpp"
+
+//where every object in the scene is and how it moves
+// - stored as a structure of arrays so the update kernels can work on 4 or 8 objects with a single instruction
+// - every object is a position, a uniform scale and a constant rotation about an axis (all the scene needs for now)
+// - the index of an object is the index it was added at
+struct Transforms {
+    std::vector<float> position_x, position_y, position_z;
+    std::vector<float> axis_x, axis_y, axis_z;     //normalised when added
+    std::vector<float> angular_speed;               //radians per second about the axis
+    std::vector<float> scale;
+
+    //returns the index of the new object
+    uint32_t add(const glm::vec3& position, const glm::vec3& axis, const float speed, const float object_scale = 1.0f) {
+        const auto index = static_cast<uint32_t>(position_x.size());
+        const auto a = glm::normalize(axis);
+        position_x.push_back(position.x); position_y.push_back(position.y); position_z.push_back(position.z);
+        axis_x.push_back(a.x); axis_y.push_back(a.y); axis_z.push_back(a.z);
+        angular_speed.push_back(speed);
+        scale.push_back(object_scale);
+        return index;
+    }
+
+    void reserve(const size_t n) {
+        position_x.reserve(n); position_y.reserve(n); position_z.reserve(n);
+        axis_x.reserve(n); axis_y.reserve(n); axis_z.reserve(n);
+        angular_speed.reserve(n);
+        scale.reserve(n);
+    }
+
+    void clear() {
+        position_x.clear(); position_y.clear(); position_z.clear();
+        axis_x.clear(); axis_y.clear(); axis_z.clear();
+        angular_speed.clear();
+        scale.clear();
+    }
+
+    [[nodiscard]] size_t size() const {return position_x.size();}
+};
+
+//the transform kernels
+// - work out the model matrix of the objects in [begin, end) at `time' seconds, and optionally the model-view-projection matrix
+// - models[i] and mvps[i] are for object i (so must have room for at least `end' matrices), mvps can be nullptr
+// - model = translate(position) * rotate(angular_speed * time, axis) * scale, mvp = view_proj * model
+// - time is a double and the angle is wrapped to [-pi, pi] (in double) first, so the result stays accurate however long the program has run
+// - all kernels give the same result (up to rounding), the SIMD versions just do 4 (SSE) or 8 (AVX2) objects at once
+void transform_range_scalar(const Transforms& transforms, double time, const glm::mat4& view_proj, size_t begin, size_t end, glm::mat4* models, glm::mat4* mvps);
+#ifdef __SSE2__
+void transform_range_sse(const Transforms& transforms, double time, const glm::mat4& view_proj, size_t begin, size_t end, glm::mat4* models, glm::mat4* mvps);
+#endif
+#ifdef __AVX2__
+void transform_range_avx2(const Transforms& transforms, double time, const glm::mat4& view_proj, size_t begin, size_t end, glm::mat4* models, glm::mat4* mvps);
+#endif
+
+//the widest kernel the engine was compiled with (see cull_range)
+void transform_range(const Transforms& transforms, double time, const glm::mat4& view_proj, size_t begin, size_t end, glm::mat4* models, glm::mat4* mvps);
+constexpr std::string_view transform_kernel_name() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+
+//works out the matrices of every object for a frame
+// - large sets are split into chunks that are done on the workers of a JobSystem (like FrustumCuller)
+struct TransformUpdater {
+    explicit TransformUpdater(JobSystem& j) : jobs(j) {}
+
+    //models (and mvps if not nullptr) must have room for transforms.size() matrices
+    void update(const Transforms& transforms, double time, const glm::mat4& view_proj, glm::mat4* models, glm::mat4* mvps = nullptr) const;
+
+    //below this many objects per thread it is faster to not split the work
+    static constexpr size_t min_objects_per_thread = 16384;
+
+private:
+    JobSystem& jobs;
+};
+
+
+#endif //VULKAN_ENGINE_TRANSFORMS_HPP
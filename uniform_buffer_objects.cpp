@@ -6,99 +6,66 @@
 #include "buffer.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
-#include <chrono>
-#include <cstring>  //for memcpy
+#include <utility>
+
+glm::mat4 UBO::camera_view() {
+    return glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+glm::mat4 UBO::camera_projection(const VkExtent2D& extent) {
+    auto proj = glm::perspective(glm::radians(45.0f), static_cast<float>(extent.width) / static_cast<float>(extent.height), 0.1f, 10.0f);
+    proj[1][1] *= -1;   //need to invert because glm aws original designed for openGL -- y-axis is flipped
+                        //the (1,1) element represents the scaling in the y-direction (clearly) and so this has the desired effect
+    return proj;
+}
+
+UBO::camera UBO::make_camera(const VkExtent2D& extent) {
+    camera c{};
+    c.view = camera_view();
+    c.proj = camera_projection(extent);
+    c.view_proj = c.proj * c.view;
+    return c;
+}
 
 void UniformBufferObject::setup() {
     //need a buffer for every image that could be in flight (so buffer for every image in the swapchain)
     uniformBuffers.resize(swap_chain.swapChainImages.size());
     uniformBuffersMemory.resize(swap_chain.swapChainImages.size());
+    mapped.resize(swap_chain.swapChainImages.size());
 
     //creating the buffers
     // - buffers are the size of the object they represent (the UBO)
     //no need for a staging buffer here since the data is updated regularly it likely won't give any performance boost
     for (size_t i = 0; i < swap_chain.swapChainImages.size(); i++) {
-        create_buffer(device, sizeof(UBO::mvp), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, uniformBuffers[i], uniformBuffersMemory[i]);
+        create_buffer(device, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, uniformBuffers[i], uniformBuffersMemory[i]);
+        //mapping once rather than every frame
+        // - https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/vkMapMemory.html
+        if (vkMapMemory(device.get_device(), uniformBuffersMemory[i], 0, size, 0, &mapped[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to map uniform buffer memory");
+        }
     }
 }
 
 void UniformBufferObject::cleanup() {
-    for (size_t i = 0; i < swap_chain.swapChainImages.size(); i++) {
+    //the number of buffers made, the swapchain may have changed since
+    // - freeing the memory also unmaps it
+    for (size_t i = 0; i < uniformBuffers.size(); i++) {
         vkDestroyBuffer(device.get_device(), uniformBuffers[i], nullptr);
         vkFreeMemory(device.get_device(), uniformBuffersMemory[i], nullptr);
     }
+    uniformBuffers.clear();
+    uniformBuffersMemory.clear();
+    mapped.clear();
 }
 
-//just rotating the mesh
-void UniformBufferObject1::update(unsigned int image_index) {
-    //setting the desired rotation
-    static auto startTime = std::chrono::high_resolution_clock::now();
-
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-
-    UBO::mvp ubo{};
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.proj = glm::perspective(glm::radians(45.0f), static_cast<float>(swap_chain.extent.width) / static_cast<float>(swap_chain.extent.height), 0.1f, 10.0f);
-    ubo.proj[1][1] *= -1;   //need to invert because glm aws original designed for openGL -- y-axis is flipped
-                            //the (1,1) element represents the scaling in the y-direction (clearly) and so this has the desired effect
-
-    //copying the data into the buffer
-    // - again don't need a staging buffer because the data is changing so frequently
-    // - in this case it is likely better to use push-constants anyway
-    void* data;
-    vkMapMemory(device.get_device(), uniformBuffersMemory[image_index], 0, sizeof(ubo), 0, &data);
-    memcpy(data, &ubo, sizeof(ubo));
-    vkUnmapMemory(device.get_device(), uniformBuffersMemory[image_index]);
+void UniformBufferObject::retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+    deletion_queue.push(frame, [d = device.get_device(), buffers = std::move(uniformBuffers), memory = std::move(uniformBuffersMemory)] {
+        for (size_t i = 0; i < buffers.size(); i++) {
+            vkDestroyBuffer(d, buffers[i], nullptr);
+            vkFreeMemory(d, memory[i], nullptr);
+        }
+    });
+    uniformBuffers.clear();
+    uniformBuffersMemory.clear();
+    mapped.clear();
 }
-
-//just rotating the mesh
-void UniformBufferObject2::update(unsigned int image_index) {
-    //setting the desired rotation
-    static auto startTime = std::chrono::high_resolution_clock::now();
-
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-
-    UBO::mvp ubo{};
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.proj = glm::perspective(glm::radians(45.0f), static_cast<float>(swap_chain.extent.width) / static_cast<float>(swap_chain.extent.height), 0.1f, 10.0f);
-    ubo.proj[1][1] *= -1;   //need to invert because glm aws original designed for openGL -- y-axis is flipped
-    //the (1,1) element represents the scaling in the y-direction (clearly) and so this has the desired effect
-
-    //copying the data into the buffer
-    // - again don't need a staging buffer because the data is changing so frequently
-    // - in this case it is likely better to use push-constants anyway
-    void* data;
-    vkMapMemory(device.get_device(), uniformBuffersMemory[image_index], 0, sizeof(ubo), 0, &data);
-    memcpy(data, &ubo, sizeof(ubo));
-    vkUnmapMemory(device.get_device(), uniformBuffersMemory[image_index]);
-}
-
-
-
-//just rotating the mesh
-void UniformBufferObject3::update(unsigned int image_index) {
-    //setting the desired rotation
-    static auto startTime = std::chrono::high_resolution_clock::now();
-
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-
-    UBO::mvp ubo{};
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-    ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.proj = glm::perspective(glm::radians(45.0f), static_cast<float>(swap_chain.extent.width) / static_cast<float>(swap_chain.extent.height), 0.1f, 10.0f);
-    ubo.proj[1][1] *= -1;   //need to invert because glm aws original designed for openGL -- y-axis is flipped
-    //the (1,1) element represents the scaling in the y-direction (clearly) and so this has the desired effect
-
-    //copying the data into the buffer
-    // - again don't need a staging buffer because the data is changing so frequently
-    // - in this case it is likely better to use push-constants anyway
-    void* data;
-    vkMapMemory(device.get_device(), uniformBuffersMemory[image_index], 0, sizeof(ubo), 0, &data);
-    memcpy(data, &ubo, sizeof(ubo));
-    vkUnmapMemory(device.get_device(), uniformBuffersMemory[image_index]);
-}
\ No newline at end of file
@@ -7,17 +7,40 @@
 
 #include <glm/glm.hpp>
 #include <vector>
+#include <cstring>  //for memcpy
+#include <stdexcept>
 #include <vulkan/vulkan.h>
 
 #include "logical_device.hpp"
 #include "swap_chain.hpp"
+#include "deletion_queue.hpp"
 
 namespace UBO {
-    struct mvp {
+    //the descriptor sets the shaders read from
+    // - the camera is at the same set in every pipeline so it is bound once per command buffer and stays bound when the pipeline changes
+    //   (as long as the pipeline layouts are compatible up to that set -- https://www.khronos.org/registry/vulkan/specs/1.3-extensions/html/chap14.html#descriptorsets-compatibility)
+    // - the per object data (and textures) come after it and are bound for every object
+    constexpr uint32_t camera_set = 0;
+    constexpr uint32_t object_set = 1;
+
+    //the data that is different for every object
+    struct object {
         glm::mat4 model;
+    };
+
+    //the data that is the same for every object
+    // - worked out once a frame (see make_camera) rather than once per object
+    struct camera {
         glm::mat4 view;
         glm::mat4 proj;
+        glm::mat4 view_proj;    //proj * view
     };
+
+    //the camera used by all the shaders
+    // - also used to build the frustum for culling so it must match what the shaders see
+    glm::mat4 camera_view();
+    glm::mat4 camera_projection(const VkExtent2D& extent);
+    camera make_camera(const VkExtent2D& extent);
 }
 
 //the buffer that holds the data for the shaders
@@ -26,37 +49,39 @@ struct UniformBufferObject {
     //and we don't want to update the buffer in preparation of the next frame while a previous one is still reading from it!
     std::vector<VkBuffer> uniformBuffers;
     std::vector<VkDeviceMemory> uniformBuffersMemory;
+    //every buffer stays mapped for as long as it exists so update is only a copy
+    // - the memory is host coherent so nothing needs flushing
+    std::vector<void*> mapped;
 
     [[nodiscard]] std::vector<VkBuffer>& get_buffers() {return uniformBuffers;}
+    [[nodiscard]] VkDeviceSize get_size() const {return size;}
 
-    UniformBufferObject(LogicalDevice& d, SwapChain &s) : device(d), swap_chain(s){}
+    //buffer_size is the size of the struct the shader reads (e.g. UBO::object or UBO::camera)
+    UniformBufferObject(LogicalDevice& d, SwapChain &s, const VkDeviceSize buffer_size = sizeof(UBO::object)) : device(d), swap_chain(s), size(buffer_size) {}
 
     void setup();
     void cleanup();
-    virtual void update(unsigned image_index) {}
+    //destroying the buffers once `frame' has finished on the GPU
+    // - setup can be called straight away to make new buffers (e.g. when the number of swapchain images changes)
+    void retire(DeletionQueue& deletion_queue, uint64_t frame);
+
+    //copying the data into the buffer for image_index
+    // - the data is worked out on the main thread (see FramePacket and Transforms), this is only the copy
+    // - T must be the struct the buffer was made for
+    template <typename T>
+    void update(const unsigned image_index, const T& data) {
+        if (sizeof(T) != size) {
+            throw std::runtime_error("data does not match the size of the uniform buffer");
+        }
+        //again don't need a staging buffer because the data is changing so frequently
+        memcpy(mapped[image_index], &data, sizeof(T));
+    }
 
 
 protected:
     LogicalDevice &device;
     SwapChain &swap_chain;
-};
-
-//rotating
-struct UniformBufferObject1 : public UniformBufferObject{
-    UniformBufferObject1(LogicalDevice& d, SwapChain &s) : UniformBufferObject(d,s) {}
-    void update(unsigned image_index) override;
-};
-
-//rotating but about a different axis
-struct UniformBufferObject2 : public UniformBufferObject{
-    UniformBufferObject2(LogicalDevice& d, SwapChain &s) : UniformBufferObject(d,s) {}
-    void update(unsigned image_index) override;
-};
-
-//rotating but the last axis
-struct UniformBufferObject3 : public UniformBufferObject{
-    UniformBufferObject3(LogicalDevice& d, SwapChain &s) : UniformBufferObject(d,s) {}
-    void update(unsigned image_index) override;
+    const VkDeviceSize size;
 };
 
 #endif //VULKAN_ENGINE_UNIFORM_BUFFER_OBJECTS_HPP
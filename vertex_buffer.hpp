@@ -12,6 +12,7 @@
 #include "vertex.hpp"
 #include <cstring>  //for memcpy
 #include "buffer.hpp"
+#include "deletion_queue.hpp"
 
 
 
@@ -85,6 +86,17 @@ struct VertexBuffer {
         vkFreeMemory(device.get_device(), vertexBufferMemory, nullptr);
     }
 
+    //destroying the buffer once `frame' has finished on the GPU
+    // - setup can be called straight away to upload new vertices (e.g. when streaming in a new mesh)
+    void retire(DeletionQueue& deletion_queue, const uint64_t frame) {
+        deletion_queue.push(frame, [d = device.get_device(), old_buffer = vertexBuffer, old_memory = vertexBufferMemory] {
+            vkDestroyBuffer(d, old_buffer, nullptr);
+            vkFreeMemory(d, old_memory, nullptr);
+        });
+        vertexBuffer = VK_NULL_HANDLE;
+        vertexBufferMemory = VK_NULL_HANDLE;
+    }
+
 
 
 
@@ -35,9 +35,29 @@ void Window::makeWindow() {
     glfwSetWindowUserPointer(window, this); //data to pass with the window pointer
                                                     // - need to update the window_resized variable on resize
     glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);  //the function to call on resize
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);            //the function to call on a mouse click
+    glfwSetKeyCallback(window, keyCallback);                            //the function to call on a key press
+
+    //the size in pixels, kept up to date by framebufferResizeCallback
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    framebuffer_width = width;
+    framebuffer_height = height;
+}
+
+void Window::makeHeadless(const int width, const int height) {
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("headless rendering needs a size larger than 0");
+    }
+    headless = true;
+    framebuffer_width = width;
+    framebuffer_height = height;
 }
 
 void Window::cleanup() const {
+    if (headless) {
+        return; //GLFW was never started
+    }
     //destroying the window and its context.
     glfwDestroyWindow(window);
     //destroys all remaining windows and cursors, restores any modified gamma ramps,
@@ -48,6 +68,24 @@ void Window::cleanup() const {
 
 void framebufferResizeCallback(GLFWwindow* window, int width, int height) {
     auto wind = reinterpret_cast<Window*>(glfwGetWindowUserPointer(window));
+    wind->framebuffer_width = width;
+    wind->framebuffer_height = height;
     wind->window_resized = true;
+}
 
-}
\ No newline at end of file
+void mouseButtonCallback(GLFWwindow* window, int button, int action, [[maybe_unused]] int mods) {
+    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) {
+        return;
+    }
+    auto wind = reinterpret_cast<Window*>(glfwGetWindowUserPointer(window));
+    glfwGetCursorPos(window, &wind->click_x, &wind->click_y);
+    wind->mouse_clicked = true;
+}
+
+void keyCallback(GLFWwindow* window, int key, [[maybe_unused]] int scancode, int action, [[maybe_unused]] int mods) {
+    if (key != GLFW_KEY_P || action != GLFW_PRESS) {
+        return;
+    }
+    auto wind = reinterpret_cast<Window*>(glfwGetWindowUserPointer(window));
+    wind->present_policy_key = true;
+}
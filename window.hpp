@@ -6,6 +6,7 @@
 #define VULKAN_ENGINE_WINDOW_HPP
 
 #include <GLFW/glfw3.h>
+#include <atomic>
 
 struct Window {
     GLFWwindow* window{}; //object to hold the window and a context
@@ -14,15 +15,37 @@ struct Window {
     const char* window_name = "Vulkan";
 
     void makeWindow();
+    //not making a window at all, the frames are rendered into offscreen images of this size
+    // - GLFW is never used so this works without a display (e.g. on a server or with a software driver)
+    void makeHeadless(int width, int height);
     void cleanup() const;
     [[nodiscard]] inline GLFWwindow* const& get_window() const {
         return window;
     }
 
-    bool window_resized = false;  //if the window was just resized (is needed for rendering)
+    //if there is no window (see makeHeadless)
+    bool headless = false;
+
+    //GLFW can only be used on the main thread but the render thread needs to know about resizes
+    // - so the callbacks (which run on the main thread) store what it needs here
+    std::atomic<bool> window_resized = false;  //if the window was just resized (is needed for rendering)
+    std::atomic<int> framebuffer_width = 0;     //the size of the window in pixels
+    std::atomic<int> framebuffer_height = 0;
+    [[nodiscard]] bool minimised() const {return framebuffer_width == 0 || framebuffer_height == 0;}
+
+    //if the left mouse button was just pressed (is needed for picking)
+    // - the cursor position is in window coordinates
+    bool mouse_clicked = false;
+    double click_x = 0.0;
+    double click_y = 0.0;
+
+    //if the key to change the present policy (P) was just pressed
+    bool present_policy_key = false;
 };
 
 void framebufferResizeCallback(GLFWwindow* window, int width, int height);
+void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
 
 #endif //VULKAN_ENGINE_WINDOW_HPP